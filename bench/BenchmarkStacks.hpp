@@ -0,0 +1,55 @@
+#ifndef BENCHMARK_STACKS_HPP
+#define BENCHMARK_STACKS_HPP
+
+#include "Playfield.hpp"
+#include <array>
+#include <span>
+
+// Stacks drawn as rows of '#' (filled) and '.' (empty), bottom row last
+using StackRows = std::span<const char* const>;
+
+// A stack with a T-spin slot, a well and a few holes, 10 rows tall
+constexpr std::array<const char*, 10> HOLES_STACK = {
+  "..........", "#.........", "##......#.", "###...###.",
+  "####.####.", "###..####.", "####.####.", "#.########",
+  "######.##.", "##.######.",
+};
+
+// A ragged stack with a T-spin slot and a well, 8 rows tall
+constexpr std::array<const char*, 8> RAGGED_STACK = {
+  "..........", "..........", "#.........", "##......#.",
+  "###...###.", "####.####.", "###..####.", "####.####.",
+};
+
+inline FallingPiece single_mino(int x, int y) {
+  FallingPiece mino(Tetromino::O, x, y);
+  mino.map = {{{0, 0}, {0, 0}, {0, 0}, {0, 0}}};
+  return mino;
+}
+
+inline Grid make_grid(StackRows stack) {
+  Grid grid;
+  for (std::size_t j = 0; j < stack.size(); j++)
+    for (int x = 0; x < int(Grid::WIDTH); x++)
+      if (stack[j][x] == '#')
+        grid.place(single_mino(x, Grid::HEIGHT - stack.size() + j));
+  return grid;
+}
+
+// Builds the stack on a seeded playfield by replaying one lock per mino, so
+// the playfield state besides the grid is that of a fresh game
+inline Playfield
+make_playfield(StackRows stack, Tetromino spawned, std::uint64_t seed) {
+  Playfield playfield(seed);
+  for (std::size_t j = 0; j < stack.size(); j++)
+    for (int x = 0; x < int(Grid::WIDTH); x++)
+      if (stack[j][x] == '#') {
+        PieceLock lock = playfield.last_lock();
+        lock.locked_piece = single_mino(x, Grid::HEIGHT - stack.size() + j);
+        lock.spawned_piece = spawned;
+        playfield.replay(lock);
+      }
+  return playfield;
+}
+
+#endif
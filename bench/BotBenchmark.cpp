@@ -0,0 +1,30 @@
+#include "BenchmarkStacks.hpp"
+#include "BotSearch.hpp"
+#include <benchmark/benchmark.h>
+
+namespace {
+// One full depth search per iteration, from a fresh game and from a stack
+void search(benchmark::State& state, bool with_stack) {
+  BotSettings settings;
+  settings.beam_width = state.range(0);
+  BotSearch bot(settings);
+  const Playfield playfield = with_stack
+    ? make_playfield(RAGGED_STACK, Tetromino::T, 0x5EED)
+    : Playfield(0x5EED);
+  const SearchState start = SearchState::of(playfield);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+      bot.search(start, std::chrono::steady_clock::time_point::max())
+    );
+}
+}; // namespace
+
+static void BM_BotSearchEmpty(benchmark::State& state) {
+  search(state, false);
+}
+BENCHMARK(BM_BotSearchEmpty)->Arg(8)->Arg(32)->Unit(benchmark::kMillisecond);
+
+static void BM_BotSearchStack(benchmark::State& state) {
+  search(state, true);
+}
+BENCHMARK(BM_BotSearchStack)->Arg(8)->Arg(32)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,67 @@
+#include "BenchmarkStacks.hpp"
+#include "Evaluator.hpp"
+#include "MoveGenerator.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace {
+// Every placement of every tetromino from the spawn position
+std::vector<FallingPiece> make_placements(const Grid& grid) {
+  MoveGenerator generator;
+  std::vector<FallingPiece> placements;
+  for (int t = 0; t < std::to_underlying(Tetromino::Empty); t++) {
+    FallingPiece piece(
+      static_cast<Tetromino>(t),
+      Playfield::INITIAL_X_POSITION,
+      Playfield::INITIAL_Y_POSITION
+    );
+    for (const auto& placement : generator.generate(grid, piece))
+      placements.push_back(placement.piece);
+  }
+  return placements;
+}
+
+// The boards those placements leave, to measure extraction on its own
+std::vector<Grid> make_boards(const Grid& grid) {
+  std::vector<Grid> boards;
+  for (const auto& piece : make_placements(grid)) {
+    Grid board = grid;
+    board.place(piece);
+    board.clear_full_rows(piece);
+    boards.push_back(board);
+  }
+  return boards;
+}
+}; // namespace
+
+static void BM_ScalarBoardFeatures(benchmark::State& state) {
+  auto boards = make_boards(make_grid(HOLES_STACK));
+  for (auto _ : state)
+    for (const auto& board : boards)
+      benchmark::DoNotOptimize(scalar_board_features(board.row_masks()));
+  state.SetItemsProcessed(state.iterations() * boards.size());
+}
+BENCHMARK(BM_ScalarBoardFeatures);
+
+static void BM_BoardFeatures(benchmark::State& state) {
+  auto boards = make_boards(make_grid(HOLES_STACK));
+  for (auto _ : state)
+    for (const auto& board : boards)
+      benchmark::DoNotOptimize(board_features(board));
+  state.SetItemsProcessed(state.iterations() * boards.size());
+  state.SetLabel(BOARD_FEATURES_ISA);
+}
+BENCHMARK(BM_BoardFeatures);
+
+// What a bot does per candidate: lock, clear, extract and weigh
+static void BM_EvaluatePlacements(benchmark::State& state) {
+  const Grid grid = make_grid(HOLES_STACK);
+  auto placements = make_placements(grid);
+  const EvaluationWeights weights;
+  for (auto _ : state)
+    for (const auto& piece : placements)
+      benchmark::DoNotOptimize(evaluate(board_features(grid, piece), weights));
+  state.SetItemsProcessed(state.iterations() * placements.size());
+  state.SetLabel(BOARD_FEATURES_ISA);
+}
+BENCHMARK(BM_EvaluatePlacements);
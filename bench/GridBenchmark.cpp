@@ -0,0 +1,110 @@
+#include "Grid.hpp"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <ranges>
+#include <vector>
+
+namespace sr = std::ranges;
+
+namespace {
+// The array-of-arrays representation Playfield used before Grid, kept here as
+// the baseline the bitboard is measured against.
+using LegacyGrid =
+  std::array<std::array<Tetromino, Grid::WIDTH>, Grid::HEIGHT>;
+
+bool legacy_fits(const LegacyGrid& grid, const FallingPiece& piece) {
+  return sr::all_of(piece.map, [&](auto coord) {
+    int x = piece.x + coord.x;
+    int y = piece.y + coord.y;
+    return x >= 0 && x < int(Grid::WIDTH) && y >= 0 &&
+      y < int(Grid::HEIGHT) && grid[y][x] == Tetromino::Empty;
+  });
+}
+
+bool legacy_empty(const LegacyGrid& grid) {
+  return sr::all_of(grid, [](const auto& row) {
+    return sr::all_of(row, [](Tetromino m) { return m == Tetromino::Empty; });
+  });
+}
+
+// A ragged stack with a few holes, 12 rows tall
+constexpr std::array<const char*, 12> STACK = {
+  "..........", "#.........", "#........#", "##......##",
+  "##.#...###", "####..####", "####.#####", "###.######",
+  "#########.", "##.#######", "#.########", "####.#####",
+};
+
+std::pair<Grid, LegacyGrid> make_grids() {
+  Grid grid;
+  LegacyGrid legacy;
+  sr::for_each(legacy, [](auto& row) { row.fill(Tetromino::Empty); });
+  for (std::size_t j = 0; j < STACK.size(); j++) {
+    int y = Grid::HEIGHT - STACK.size() + j;
+    for (int x = 0; x < int(Grid::WIDTH); x++) {
+      if (STACK[j][x] != '#')
+        continue;
+      // Single minos placed through the O piece's bottom-left cell
+      FallingPiece mino(Tetromino::O, x, y);
+      mino.map = {{{0, 0}, {0, 0}, {0, 0}, {0, 0}}};
+      grid.place(mino);
+      legacy[y][x] = Tetromino::O;
+    }
+  }
+  return {grid, legacy};
+}
+
+// Every tetromino, orientation and column over the bottom 20 rows
+std::vector<FallingPiece> make_probes() {
+  std::vector<FallingPiece> probes;
+  for (int t = 0; t < std::to_underlying(Tetromino::Empty); t++) {
+    FallingPiece piece(static_cast<Tetromino>(t), 0, 0);
+    for (int r = 0; r < 4; r++, piece.rotate(RotationType::Clockwise))
+      for (int y = Grid::HEIGHT - 20; y < int(Grid::HEIGHT); y++)
+        for (int x = -1; x <= int(Grid::WIDTH); x++) {
+          FallingPiece probe = piece;
+          probe.x = x;
+          probe.y = y;
+          probes.push_back(probe);
+        }
+  }
+  return probes;
+}
+}; // namespace
+
+static void BM_LegacyFits(benchmark::State& state) {
+  auto legacy = make_grids().second;
+  auto probes = make_probes();
+  for (auto _ : state)
+    for (const auto& piece : probes)
+      benchmark::DoNotOptimize(legacy_fits(legacy, piece));
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK(BM_LegacyFits);
+
+static void BM_GridFits(benchmark::State& state) {
+  auto grid = make_grids().first;
+  auto probes = make_probes();
+  for (auto _ : state)
+    for (const auto& piece : probes)
+      benchmark::DoNotOptimize(grid.fits(piece));
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK(BM_GridFits);
+
+static void BM_LegacyEmpty(benchmark::State& state) {
+  auto legacy = make_grids().second;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(legacy);
+    benchmark::DoNotOptimize(legacy_empty(legacy));
+  }
+}
+BENCHMARK(BM_LegacyEmpty);
+
+static void BM_GridEmpty(benchmark::State& state) {
+  auto grid = make_grids().first;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(grid);
+    benchmark::DoNotOptimize(grid.empty());
+  }
+}
+BENCHMARK(BM_GridEmpty);
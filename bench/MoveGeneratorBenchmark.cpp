@@ -0,0 +1,41 @@
+#include "BenchmarkStacks.hpp"
+#include "MoveGenerator.hpp"
+#include <benchmark/benchmark.h>
+
+namespace {
+// A stack with a T-spin slot and an overhang to tuck under, 8 rows tall
+constexpr std::array<const char*, 8> STACK = {
+  "..........", "..........", "#.........", "##......##",
+  "###...####", "####.#####", "###..#####", "####.#####",
+};
+
+void generate(benchmark::State& state, bool with_stack) {
+  const Grid grid = with_stack ? make_grid(STACK) : Grid();
+  MoveGenerator generator;
+  std::size_t placements = 0;
+  for (auto _ : state) {
+    for (int t = 0; t < std::to_underlying(Tetromino::Empty); t++) {
+      FallingPiece piece(
+        static_cast<Tetromino>(t),
+        Playfield::INITIAL_X_POSITION,
+        Playfield::INITIAL_Y_POSITION
+      );
+      placements += generator.generate(grid, piece).size();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * 7);
+  state.counters["placements"] = benchmark::Counter(
+    placements, benchmark::Counter::kAvgIterations
+  );
+}
+}; // namespace
+
+static void BM_GenerateEmpty(benchmark::State& state) {
+  generate(state, false);
+}
+BENCHMARK(BM_GenerateEmpty);
+
+static void BM_GenerateStack(benchmark::State& state) {
+  generate(state, true);
+}
+BENCHMARK(BM_GenerateStack);
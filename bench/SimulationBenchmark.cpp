@@ -0,0 +1,183 @@
+#include "BenchmarkStacks.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// Everything here is seeded, so two runs of the same build simulate exactly
+// the same pieces and inputs and only the code under test changes the numbers
+namespace {
+constexpr std::uint64_t SEED = 0x5EED;
+const HandlingSettings SETTINGS;
+
+Inputs press(Action action) {
+  Inputs inputs;
+  inputs.set(action);
+  return inputs;
+}
+
+// Bottom rows full except for a well in the first column
+constexpr std::array<const char*, 4> WELL = {
+  ".#########", ".#########", ".#########", ".#########",
+};
+
+// A vertical I piece sitting over the well, one hard drop away from clearing
+// the given number of lines
+Playfield make_clear(std::size_t lines) {
+  Playfield playfield = make_playfield(
+    StackRows(WELL).last(lines), Tetromino::I, SEED
+  );
+  playfield.update(press(Action::Clockwise), SETTINGS);
+  for (int frame = 0; frame < int(Grid::WIDTH / 2); frame++)
+    playfield.update(press(Action::Left), SETTINGS);
+  return playfield;
+}
+
+// Per-frame inputs drawn once from a fixed seed, with about the same mix as
+// the headless random player
+std::vector<Inputs> make_trace(std::size_t frames) {
+  static constexpr std::array<std::pair<Action, unsigned int>, 10> ODDS = {{
+    {Action::Swap, 40},
+    {Action::Left, 6},
+    {Action::Right, 6},
+    {Action::LeftDas, 10},
+    {Action::RightDas, 10},
+    {Action::Clockwise, 8},
+    {Action::CounterClockwise, 8},
+    {Action::OneEighty, 30},
+    {Action::HardDrop, 20},
+    {Action::SoftDrop, 4},
+  }};
+  Pcg32 generator(SEED);
+  std::vector<Inputs> trace(frames);
+  for (Inputs& inputs : trace)
+    for (auto [action, one_in] : ODDS)
+      inputs.set(action, generator.bounded(one_in) == 0);
+  return trace;
+}
+
+constexpr std::array<const char*, 8> STACK = {
+  "..........", "..........", "#.........", "##......##",
+  "###...####", "####.#####", "###..#####", "####.#####",
+};
+}; // namespace
+
+static void BM_Fits(benchmark::State& state) {
+  const Grid grid = make_grid(STACK);
+  std::vector<FallingPiece> probes;
+  for (int t = 0; t < std::to_underlying(Tetromino::Empty); t++)
+    for (int x = -1; x <= int(Grid::WIDTH); x++)
+      probes.emplace_back(static_cast<Tetromino>(t), x, Grid::HEIGHT - 4);
+  for (auto _ : state)
+    for (const auto& piece : probes)
+      benchmark::DoNotOptimize(grid.fits(piece));
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK(BM_Fits);
+
+// Copy plus one hard drop that locks the piece and clears range(0) lines,
+// compare with BM_PlayfieldCopy for the lock alone
+static void BM_HardDropClear(benchmark::State& state) {
+  const Playfield prepared = make_clear(state.range(0));
+  Playfield check = prepared;
+  check.update(press(Action::HardDrop), SETTINGS);
+  // Four lines empty the grid, which shows up as an all clear instead
+  auto lines = state.range(0);
+  auto expected =
+    lines == 4 ? MessageType::AllClear : static_cast<MessageType>(lines);
+  if (check.last_lock().message.message != expected)
+    state.SkipWithError("setup did not clear the expected lines");
+  for (auto _ : state) {
+    Playfield playfield = prepared;
+    benchmark::DoNotOptimize(
+      playfield.update(press(Action::HardDrop), SETTINGS)
+    );
+    benchmark::DoNotOptimize(playfield);
+  }
+}
+BENCHMARK(BM_HardDropClear)->DenseRange(0, 4);
+
+static void BM_PlayfieldCopy(benchmark::State& state) {
+  const Playfield prepared = make_playfield(STACK, Tetromino::T, SEED);
+  for (auto _ : state) {
+    Playfield playfield = prepared;
+    benchmark::DoNotOptimize(playfield);
+  }
+}
+BENCHMARK(BM_PlayfieldCopy);
+
+static void BM_IsSpin(benchmark::State& state) {
+  const Grid grid = make_grid(STACK);
+  std::vector<FallingPiece> probes;
+  FallingPiece piece(Tetromino::T, 0, 0);
+  for (int r = 0; r < 4; r++, piece.rotate(RotationType::Clockwise))
+    for (int y = Grid::HEIGHT - STACK.size(); y < int(Grid::HEIGHT); y++)
+      for (int x = 0; x < int(Grid::WIDTH); x++) {
+        FallingPiece probe = piece;
+        probe.x = x;
+        probe.y = y;
+        if (grid.fits(probe))
+          probes.push_back(probe);
+      }
+  for (auto _ : state)
+    for (const auto& probe : probes)
+      benchmark::DoNotOptimize(is_spin(probe, grid));
+  state.SetItemsProcessed(state.iterations() * probes.size());
+}
+BENCHMARK(BM_IsSpin);
+
+template <class Randomizer>
+static void BM_NextTetromino(benchmark::State& state) {
+  BasicNextQueue<Randomizer> next_queue(SEED);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(next_queue.next_tetromino());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NextTetromino<SevenBag>);
+BENCHMARK(BM_NextTetromino<FourteenBag>);
+BENCHMARK(BM_NextTetromino<ClassicRandom>);
+BENCHMARK(BM_NextTetromino<TgmHistory>);
+
+static void BM_RotatedTranslated(benchmark::State& state) {
+  std::vector<FallingPiece> pieces;
+  for (int t = 0; t < std::to_underlying(Tetromino::Empty); t++)
+    pieces.emplace_back(static_cast<Tetromino>(t), 4, 20);
+  for (auto _ : state)
+    for (auto& piece : pieces) {
+      piece = piece.rotated(RotationType::Clockwise).translated({1, 0});
+      piece = piece.translated({-1, 0});
+      benchmark::DoNotOptimize(piece);
+    }
+  state.SetItemsProcessed(state.iterations() * pieces.size());
+}
+BENCHMARK(BM_RotatedTranslated);
+
+// Nothing but hard drops, restarting on top out: the spawn, drop, lock and
+// clear cycle with no movement in between
+static void BM_HardDropCycle(benchmark::State& state) {
+  Playfield playfield(SEED);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+      playfield.update(press(Action::HardDrop), SETTINGS)
+    );
+    if (playfield.lost())
+      playfield.restart();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HardDropCycle);
+
+// Full games driven by a fixed input trace
+static void BM_InputTrace(benchmark::State& state) {
+  const auto trace = make_trace(state.range(0));
+  std::size_t frames = 0;
+  for (auto _ : state) {
+    Playfield playfield(SEED);
+    for (Inputs inputs : trace) {
+      if (playfield.lost())
+        playfield.restart();
+      benchmark::DoNotOptimize(playfield.update(inputs, SETTINGS));
+    }
+    frames += trace.size();
+  }
+  state.SetItemsProcessed(frames);
+}
+BENCHMARK(BM_InputTrace)->Arg(1 << 14);
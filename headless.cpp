@@ -0,0 +1,347 @@
+#include "BotController.hpp"
+#include "GameBatch.hpp"
+#include "Match.hpp"
+#include "Playfield.hpp"
+#include "Profiler.hpp"
+#include "Replay.hpp"
+#include "ThreadPool.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Steps games with random inputs as fast as the CPU allows, without a window.
+// Every game reseeds the generator, so results do not depend on the thread
+// that happened to run it.
+static thread_local std::minstd_rand input_generator;
+
+template <unsigned int ONE_IN>
+static bool random_input() {
+  return input_generator() % ONE_IN == 0;
+}
+
+static constexpr Controller RANDOM_CONTROLS{
+  []() -> bool { return false; },
+  random_input<40>,
+  random_input<6>,
+  random_input<6>,
+  random_input<10>,
+  random_input<10>,
+  random_input<8>,
+  random_input<8>,
+  random_input<30>,
+  random_input<20>,
+  random_input<4>,
+  []() -> bool { return false; },
+  []() -> bool { return false; },
+  []() -> bool { return false; },
+  []() -> bool { return false; },
+};
+
+// Searched on the worker's own thread to the full depth, so bot games are as
+// reproducible as random ones
+static constexpr BotSettings BOT_SETTINGS = [] {
+  BotSettings settings;
+  settings.beam_width = 16;
+  return settings;
+}();
+
+struct Options {
+  unsigned threads = std::thread::hardware_concurrency();
+  const char* record_dir = nullptr;
+  long batch_size = 0;
+  long versus_players = 0;
+  bool replay = false;
+  // Bots play instead of random inputs
+  bool bot = false;
+  // Positional arguments, or replay files with --replay
+  std::vector<const char*> args;
+
+  long arg(std::size_t index, long fallback) const {
+    return index < args.size() ? std::atol(args[index]) : fallback;
+  }
+  std::uint64_t seed(std::size_t index) const {
+    return index < args.size() ? std::strtoull(args[index], nullptr, 0) : 0;
+  }
+};
+
+static Options parse_options(int argc, char** argv) {
+  Options options;
+  int arg = 1;
+  for (; arg < argc; arg++) {
+    std::string_view flag = argv[arg];
+    if (flag == "--threads" && arg + 1 < argc)
+      options.threads = std::atol(argv[++arg]);
+    else if (flag == "--record" && arg + 1 < argc)
+      options.record_dir = argv[++arg];
+    else if (flag == "--batch" && arg + 1 < argc)
+      options.batch_size = std::atol(argv[++arg]);
+    else if (flag == "--versus" && arg + 1 < argc)
+      options.versus_players = std::atol(argv[++arg]);
+    else if (flag == "--replay")
+      options.replay = true;
+    else if (flag == "--bot")
+      options.bot = true;
+    else
+      break;
+    if (options.replay) {
+      arg++;
+      break;
+    }
+  }
+  options.args.assign(argv + arg, argv + argc);
+  return options;
+}
+
+// Sums of per-worker counters, each on its own cache line
+struct alignas(64) Totals {
+  std::uint64_t frames = 0;
+  std::uint64_t pieces = 0;
+  std::uint64_t passed = 0;
+  std::uint64_t lost = 0;
+  std::uint64_t score = 0;
+  std::uint64_t allocations = 0;
+};
+
+// Heap allocations the calling thread made so far, only counted in profiling
+// builds
+static std::uint64_t heap_allocations() {
+#ifdef RAYTRIS_PROFILE
+  return profiler::heap_stats().allocations;
+#else
+  return 0;
+#endif
+}
+
+static Totals sum(const std::vector<Totals>& per_worker) {
+  Totals total;
+  for (const Totals& totals : per_worker) {
+    total.frames += totals.frames;
+    total.pieces += totals.pieces;
+    total.passed += totals.passed;
+    total.lost += totals.lost;
+    total.score += totals.score;
+    total.allocations += totals.allocations;
+  }
+  return total;
+}
+
+static const char* to_string(ReplayResult result) {
+  switch (result) {
+  case ReplayResult::Verified:
+    return "verified";
+  case ReplayResult::Mismatch:
+    return "final state mismatch";
+  case ReplayResult::Truncated:
+    return "truncated";
+  case ReplayResult::Invalid:
+    return "not a replay";
+  }
+  return "";
+}
+
+// Re-simulates every replay and checks it ends where the recording did
+static int verify_replays(const Options& options, ThreadPool& pool) {
+  const auto& paths = options.args;
+  std::vector<Totals> per_worker(pool.size());
+  std::vector<ReplayResult> results(paths.size());
+  const auto start = std::chrono::steady_clock::now();
+  pool.parallel_for(paths.size(), [&](std::size_t replay, unsigned worker) {
+    ReplaySummary summary;
+    results[replay] = verify_replay(paths[replay], &summary);
+    per_worker[worker].frames += summary.frames;
+    per_worker[worker].pieces += summary.locks;
+    per_worker[worker].passed += results[replay] == ReplayResult::Verified;
+  });
+  const std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  for (std::size_t replay = 0; replay < paths.size(); replay++)
+    if (results[replay] != ReplayResult::Verified)
+      std::printf("%s: %s\n", paths[replay], to_string(results[replay]));
+  Totals total = sum(per_worker);
+  std::printf(
+    "%llu/%zu replays verified on %u threads, %llu frames in %.3fs "
+    "(%.0f frames/s)\n",
+    static_cast<unsigned long long>(total.passed),
+    paths.size(),
+    pool.size(),
+    static_cast<unsigned long long>(total.frames),
+    elapsed.count(),
+    total.frames / elapsed.count()
+  );
+  return total.passed == paths.size() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Steps a GameBatch with random actions, the way a trainer would drive it
+static int run_batch(const Options& options, ThreadPool& pool) {
+  const long size = options.batch_size;
+  const long steps = options.arg(0, 10000);
+  const std::uint64_t seed = options.seed(1);
+  input_generator.seed(seed);
+  GameBatch batch(size, seed);
+  std::vector<Inputs> actions(size);
+
+  long episodes = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (long step = 0; step < steps; step++) {
+    for (Inputs& action : actions)
+      action = RANDOM_CONTROLS.poll();
+    batch.step(actions, pool);
+    for (auto done : batch.done())
+      episodes += done;
+  }
+  const std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  std::printf(
+    "%ld games on %u threads, %ld steps, %ld episodes in %.3fs "
+    "(%.0f game steps/s)\n",
+    size,
+    pool.size(),
+    steps,
+    episodes,
+    elapsed.count(),
+    size * steps / elapsed.count()
+  );
+  return EXIT_SUCCESS;
+}
+
+static int run_games(const Options& options, ThreadPool& pool) {
+  const long games = options.arg(0, 1000);
+  const long max_frames = options.arg(1, 100000);
+  const std::uint64_t seed = options.seed(2);
+  const HandlingSettings settings;
+
+  std::vector<Totals> per_worker(pool.size());
+  const auto start = std::chrono::steady_clock::now();
+  pool.parallel_for(games, [&](std::size_t game, unsigned worker) {
+    input_generator.seed(seed + game);
+    Playfield playfield(seed + game);
+    std::optional<ReplayWriter> recorder;
+    if (options.record_dir) {
+      auto path = std::string(options.record_dir) + "/game-";
+      recorder.emplace(path + std::to_string(game) + ".raytris", settings);
+      recorder->begin(playfield);
+    }
+    std::optional<BotController> bot;
+    if (options.bot)
+      bot.emplace(BOT_SETTINGS);
+
+    Totals& totals = per_worker[worker];
+    const auto allocations = heap_allocations();
+    for (long frame = 0; frame < max_frames && !playfield.lost(); frame++) {
+      Inputs inputs =
+        bot ? bot->tick(playfield, settings) : RANDOM_CONTROLS.poll();
+      bool locked = playfield.update(inputs, settings);
+      if (recorder)
+        recorder->record(inputs, locked);
+      totals.pieces += locked;
+      totals.frames++;
+    }
+    totals.allocations += heap_allocations() - allocations;
+    if (recorder)
+      recorder->finish(playfield);
+    totals.lost += playfield.lost();
+    totals.score += playfield.get_score();
+  });
+  const std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  Totals total = sum(per_worker);
+  std::printf(
+    "%ld games on %u threads, %llu frames, %llu pieces in %.3fs "
+    "(%.0f frames/s, %.0f pieces/s)\n",
+    games,
+    pool.size(),
+    static_cast<unsigned long long>(total.frames),
+    static_cast<unsigned long long>(total.pieces),
+    elapsed.count(),
+    total.frames / elapsed.count(),
+    total.pieces / elapsed.count()
+  );
+  if (options.bot)
+    std::printf(
+      "%llu topped out, %.1f points per piece\n",
+      static_cast<unsigned long long>(total.lost),
+      double(total.score) / total.pieces
+    );
+#ifdef RAYTRIS_PROFILE
+  std::printf(
+    "%llu heap allocations while playing\n",
+    static_cast<unsigned long long>(total.allocations)
+  );
+#endif
+  return EXIT_SUCCESS;
+}
+
+// Plays versus matches between random players or bots, the way a bot
+// tournament would be scheduled
+static int run_versus(const Options& options, ThreadPool& pool) {
+  const std::size_t players = options.versus_players;
+  const long matches = options.arg(0, 100);
+  const long max_frames = options.arg(1, 100000);
+  const std::uint64_t seed = options.seed(2);
+
+  const auto policy =
+    [&](std::size_t match, const Match& boards, std::size_t board) {
+      // Matches never move between workers, starting over when a new one
+      // starts keeps every match's inputs independent of the thread it ran on
+      thread_local std::size_t current_match = -1;
+      thread_local std::vector<std::unique_ptr<BotController>> bots;
+      if (match != current_match) {
+        current_match = match;
+        input_generator.seed(seed + match);
+        bots.clear();
+        if (options.bot)
+          for (std::size_t player = 0; player < players; player++)
+            bots.push_back(std::make_unique<BotController>(BOT_SETTINGS));
+      }
+      if (options.bot)
+        return bots[board]->tick(boards[board], HandlingSettings{});
+      return RANDOM_CONTROLS.poll();
+    };
+  const auto start = std::chrono::steady_clock::now();
+  auto results =
+    play_matches(pool, matches, players, seed, max_frames, policy);
+  const std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  std::vector<long> wins(players + 1);
+  std::uint64_t frames = 0;
+  for (const MatchResult& result : results) {
+    wins[result.winner]++;
+    frames += result.frames;
+  }
+  std::printf(
+    "%ld matches of %zu players on %u threads, %llu frames in %.3fs "
+    "(%.0f match frames/s)\n",
+    matches,
+    players,
+    pool.size(),
+    static_cast<unsigned long long>(frames),
+    elapsed.count(),
+    frames / elapsed.count()
+  );
+  for (std::size_t player = 0; player < players; player++)
+    std::printf("player %zu: %ld wins\n", player, wins[player]);
+  std::printf("undecided: %ld\n", wins[players]);
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv) {
+  const Options options = parse_options(argc, argv);
+  ThreadPool pool(options.threads);
+  if (options.replay)
+    return verify_replays(options, pool);
+  if (options.batch_size > 0)
+    return run_batch(options, pool);
+  if (options.versus_players > 0)
+    return run_versus(options, pool);
+  return run_games(options, pool);
+}
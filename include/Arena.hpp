@@ -0,0 +1,113 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+
+// A fixed number of default constructed T, allocated once. allocate() hands
+// them out in order and reset() takes them all back at once, so code that
+// builds and throws away many short lived objects never touches the heap.
+// Handed out objects keep their address until the arena is destroyed.
+template <class T>
+class Arena {
+  std::unique_ptr<T[]> items;
+  std::size_t capacity_;
+  std::size_t used = 0;
+
+public:
+  explicit Arena(std::size_t capacity) :
+    items(std::make_unique<T[]>(capacity)),
+    capacity_(capacity) {}
+
+  // nullptr once every object is in use
+  T* allocate() {
+    return used < capacity_ ? &items[used++] : nullptr;
+  }
+  void reset() {
+    used = 0;
+  }
+  T& operator[](std::size_t index) {
+    return items[index];
+  }
+  const T& operator[](std::size_t index) const {
+    return items[index];
+  }
+  // Index of an object from allocate()
+  std::size_t index_of(const T& item) const {
+    return &item - items.get();
+  }
+  std::size_t size() const {
+    return used;
+  }
+  std::size_t capacity() const {
+    return capacity_;
+  }
+};
+
+// A queue of at most a fixed number of T, in storage allocated once, that
+// drops from either end. Unlike Arena, items are only constructed when pushed,
+// so T needs no default constructor and unused slots cost nothing to set up.
+template <class T>
+class RingBuffer {
+  struct Deallocate {
+    std::size_t capacity;
+    void operator()(T* items) const {
+      std::allocator<T>().deallocate(items, capacity);
+    }
+  };
+  std::unique_ptr<T, Deallocate> items;
+  std::size_t first = 0;
+  std::size_t used = 0;
+
+  T* slot(std::size_t index) const {
+    return items.get() + (first + index) % capacity();
+  }
+
+public:
+  explicit RingBuffer(std::size_t capacity) :
+    items(std::allocator<T>().allocate(capacity), Deallocate{capacity}) {}
+  RingBuffer(const RingBuffer&) = delete;
+  RingBuffer& operator=(const RingBuffer&) = delete;
+  ~RingBuffer() {
+    clear();
+  }
+
+  void push_back(const T& item) {
+    assert(used < capacity());
+    std::construct_at(slot(used), item);
+    used++;
+  }
+  // Drops the count oldest
+  void pop_front(std::size_t count = 1) {
+    assert(count <= used);
+    for (std::size_t i = 0; i < count; i++)
+      std::destroy_at(slot(i));
+    first = (first + count) % capacity();
+    used -= count;
+  }
+  // Drops all but the size oldest
+  void truncate(std::size_t size) {
+    for (; used > size; used--)
+      std::destroy_at(slot(used - 1));
+  }
+  void clear() {
+    truncate(0);
+    first = 0;
+  }
+  // Index 0 is the oldest
+  T& operator[](std::size_t index) {
+    return *slot(index);
+  }
+  const T& operator[](std::size_t index) const {
+    return *slot(index);
+  }
+  std::size_t size() const {
+    return used;
+  }
+  std::size_t capacity() const {
+    return items.get_deleter().capacity;
+  }
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef AUTOSAVE_HPP
+#define AUTOSAVE_HPP
+
+#include "Playfield.hpp"
+#include "Serialization.hpp"
+#include <fstream>
+#include <optional>
+#include <string>
+
+// Incremental save file: a full snapshot followed by one small record per
+// locked piece. Locks are appended as they happen, so saving never rewrites
+// the file mid-game, and after MAX_LOCKS appended records the snapshot is
+// rewritten to keep loading fast.
+class Autosave {
+public:
+  static constexpr std::size_t MAX_LOCKS = 256;
+
+private:
+  std::string path;
+  std::ofstream out;
+  std::size_t locks = 0;
+  BitWriter writer;
+
+public:
+  Autosave(std::string);
+  static std::optional<Playfield> load(const std::string&);
+  void snapshot(const Playfield&);
+  void lock(const Playfield&);
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef BOT_CONTROLLER_HPP
+#define BOT_CONTROLLER_HPP
+
+#include "BotSearch.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Plays a playfield from a BotSearch, one tick of Inputs at a time. Once the
+// last plan's piece locked, the playfield as it is gets searched, then
+// the planned placement is turned into inputs from wherever the piece is by
+// then. A lock, a swap or garbage while the search ran makes the plan stale,
+// and the playfield is searched again.
+//
+// With a time budget the search runs on a thread of its own, and tick() only
+// checks for its result, so a frame never waits on the bot. Without one the
+// search runs inside tick().
+class BotController {
+  BotSettings settings;
+  BotSearch search;
+  MoveGenerator generator;
+  std::vector<Inputs> planned;
+  std::size_t next_input = 0;
+  std::uint32_t planned_revision = 0;
+  unsigned int wait_frames = 0;
+  std::optional<BotPlan> target;
+
+  // What the searched playfield looked like, to tell when a plan is stale
+  struct Snapshot {
+    std::uint32_t grid_revision;
+    Tetromino falling;
+    Tetromino hold;
+    bool operator==(const Snapshot&) const = default;
+  };
+  bool searching = false;
+  Snapshot searched;
+
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::optional<SearchState> request;
+  bool has_result = false;
+  std::optional<BotPlan> result;
+  bool stopping = false;
+  std::thread worker;
+
+  static Snapshot snapshot(const Playfield&);
+  void start_search(const Playfield&);
+  bool take_result(std::optional<BotPlan>&);
+  Inputs begin_plan(const Playfield&, const HandlingSettings&);
+  void run();
+
+public:
+  BotController(const BotSettings& = {});
+  BotController(const BotController&) = delete;
+  BotController& operator=(const BotController&) = delete;
+  ~BotController();
+  Inputs tick(const Playfield&, const HandlingSettings&);
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef BOT_SEARCH_HPP
+#define BOT_SEARCH_HPP
+
+#include "Arena.hpp"
+#include "Evaluator.hpp"
+#include "MoveGenerator.hpp"
+#include <chrono>
+#include <optional>
+#include <vector>
+
+struct BotSettings {
+  // Boards kept after each piece
+  std::size_t beam_width = 32;
+  // Pieces placed along every line of play, the falling one included
+  std::size_t depth = NextQueue::NEXT_SIZE + 1;
+  // Longest a search may take. Zero searches on the caller's thread to the
+  // full depth, so the moves only depend on the game.
+  std::chrono::milliseconds time_budget{0};
+  // Ticks to wait after every lock before moving the next piece
+  unsigned int delay_frames = 0;
+  // Score of every garbage line sent along a line of play
+  int attack_weight = 200;
+  EvaluationWeights weights;
+};
+
+// What the bot plans from: the board, the pieces it can play and the counts
+// its attacks depend on. Incoming garbage is not planned for.
+struct SearchState {
+  Grid grid;
+  FallingPiece falling{Tetromino::Empty, 0, 0};
+  Tetromino hold;
+  bool can_swap;
+  std::array<Tetromino, NextQueue::NEXT_SIZE> next;
+  unsigned int combo;
+  unsigned int b2b;
+
+  static SearchState of(const Playfield&);
+};
+
+// The first placement of the best line of play found
+struct BotPlan {
+  // Whether to swap with the hold before moving
+  bool swap;
+  FallingPiece piece;
+  SpinType spin;
+  int score;
+  // Pieces placed along the line of play
+  std::size_t depth;
+};
+
+// Beam search over the falling piece, the hold and the preview. Every depth
+// places one more piece, with and without swapping, on each board kept, and
+// keeps the beam_width best by the attack sent so far plus the evaluation
+// of the board left. Boards reached twice, in another order or through the
+// hold, are only kept once.
+//
+// Nodes come from an arena and the transposition table is kept between
+// searches, a search does not allocate.
+class BotSearch {
+  struct Node {
+    Grid grid;
+    Tetromino hold;
+    // Position in the piece sequence of the next piece to play
+    std::uint8_t index;
+    unsigned int combo;
+    unsigned int b2b;
+    int reward;
+    int score;
+    // The depth one node this line of play started with
+    std::uint32_t first;
+    // The placement that led here
+    bool swap;
+    FallingPiece piece{Tetromino::Empty, 0, 0};
+    SpinType spin;
+  };
+
+  struct Candidate {
+    std::uint32_t parent;
+    std::uint32_t order;
+    bool swap;
+    FallingPiece piece;
+    SpinType spin;
+    Tetromino hold;
+    std::uint8_t index;
+    unsigned int combo;
+    unsigned int b2b;
+    int reward;
+    int score;
+  };
+
+  // Remembers which keys a beam holds. Entries are stamped with the beam
+  // they were seen in, so starting a new beam clears nothing, and a
+  // colliding key just replaces the old one.
+  class TranspositionTable {
+    struct Entry {
+      std::uint64_t key = 0;
+      std::uint32_t stamp = 0;
+    };
+    std::vector<Entry> entries;
+
+  public:
+    explicit TranspositionTable(std::size_t size_log2);
+    // Whether key is new to the beam stamp, which then holds it
+    bool insert(std::uint64_t key, std::uint32_t stamp);
+  };
+
+  using Sequence = std::array<Tetromino, NextQueue::NEXT_SIZE + 1>;
+
+  BotSettings settings;
+  MoveGenerator generator;
+  Arena<Node> nodes;
+  TranspositionTable table;
+  std::uint32_t stamp = 0;
+  std::vector<Candidate> candidates;
+  std::vector<std::uint32_t> beam;
+  std::vector<std::uint32_t> next_beam;
+  Grid scratch;
+
+  void expand(std::uint32_t, const SearchState&, const Sequence&);
+  void add_candidates(
+    std::uint32_t, const FallingPiece&, bool swap, Tetromino hold, int index
+  );
+
+public:
+  BotSearch(const BotSettings& = {});
+  // The best first placement, nullopt when every one tops out
+  std::optional<BotPlan>
+  search(const SearchState&, std::chrono::steady_clock::time_point deadline);
+};
+
+#endif
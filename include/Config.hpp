@@ -0,0 +1,35 @@
+#ifndef CONFIG_HPP
+#define CONFIG_HPP
+
+#include "HandlingSettings.hpp"
+#include <iosfwd>
+#include <optional>
+
+enum class Resolution {
+  Small,
+  Medium,
+  Big,
+  FullScreen
+};
+
+// How often frames are drawn, the simulation ticks at the same rate in all
+enum class RenderMode {
+  VSync,
+  Uncapped,
+  // Only frames that ran a tick are drawn, the others are skipped
+  TickRate
+};
+
+// What settings.raytris holds, read and written apart from the menu so it
+// needs no window
+struct Config {
+  Resolution resolution = Resolution::Small;
+  HandlingSettings handling_settings;
+  RenderMode render_mode = RenderMode::VSync;
+};
+
+void write_config(std::ostream&, const Config&);
+// Settings added after the file was written keep their defaults
+std::optional<Config> read_config(std::istream&);
+
+#endif
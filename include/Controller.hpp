@@ -1,6 +1,59 @@
 #ifndef CONTROLLER_H
 #define CONTROLLER_H
 
+#include <cstdint>
+#include <utility>
+
+enum class Action : unsigned char {
+  Restart,
+  Swap,
+  Left,
+  Right,
+  LeftDas,
+  RightDas,
+  Clockwise,
+  CounterClockwise,
+  OneEighty,
+  HardDrop,
+  SoftDrop,
+  Undo,
+  Redo,
+  Pause,
+  Quit
+};
+
+// One tick worth of input, one bit per Action
+class Inputs {
+  std::uint16_t bits = 0;
+
+public:
+  static constexpr unsigned int BITS = std::to_underlying(Action::Quit) + 1;
+
+  constexpr Inputs() = default;
+  constexpr explicit Inputs(std::uint16_t _bits) : bits(_bits) {}
+  constexpr bool operator[](Action action) const {
+    return bits >> std::to_underlying(action) & 1;
+  }
+  constexpr void set(Action action, bool value = true) {
+    auto bit = std::uint16_t(1u << std::to_underlying(action));
+    bits = value ? bits | bit : bits & ~bit;
+  }
+  constexpr std::uint16_t mask() const {
+    return bits;
+  }
+  // Only the actions that stay on while their key is down, every other one
+  // is a single press
+  constexpr Inputs held() const {
+    constexpr auto HELD = std::uint16_t(
+      1u << std::to_underlying(Action::LeftDas) |
+      1u << std::to_underlying(Action::RightDas) |
+      1u << std::to_underlying(Action::SoftDrop)
+    );
+    return Inputs(bits & HELD);
+  }
+  constexpr bool operator==(const Inputs&) const = default;
+};
+
 struct Controller {
   using Input = bool (*)();
   Input restart;
@@ -15,8 +68,30 @@ struct Controller {
   Input check_hard_drop;
   Input soft_drop;
   Input undo;
+  Input redo;
   Input pause;
   Input quit;
+
+  // Samples every input once
+  Inputs poll() const {
+    Inputs inputs;
+    inputs.set(Action::Restart, restart());
+    inputs.set(Action::Swap, swap());
+    inputs.set(Action::Left, left());
+    inputs.set(Action::Right, right());
+    inputs.set(Action::LeftDas, left_das());
+    inputs.set(Action::RightDas, right_das());
+    inputs.set(Action::Clockwise, clockwise());
+    inputs.set(Action::CounterClockwise, counter_clockwise());
+    inputs.set(Action::OneEighty, one_eighty());
+    inputs.set(Action::HardDrop, check_hard_drop());
+    inputs.set(Action::SoftDrop, soft_drop());
+    inputs.set(Action::Undo, undo());
+    inputs.set(Action::Redo, redo());
+    inputs.set(Action::Pause, pause());
+    inputs.set(Action::Quit, quit());
+    return inputs;
+  }
 };
 
 #endif
@@ -2,10 +2,24 @@
 #define DRAWING_DETAILS_H
 
 #include "raylib.h"
+#include <array>
 
 struct DrawingDetails {
   static constexpr float HEIGHT_SCALE_FACTOR = 0.80;
   static constexpr Color DEFAULT_PRETTY_OUTLINE = {0, 0, 0, 255 / 8};
+  // In Tetromino order
+  static constexpr std::array<Color, 7> TETROMINO_COLORS = {
+    {{49, 199, 239, 255},
+     {247, 211, 8, 255},
+     {173, 77, 156, 255},
+     {239, 32, 41, 255},
+     {66, 182, 66, 255},
+     {90, 101, 173, 255},
+     {239, 121, 33, 255}}
+  };
+  static constexpr Color GHOST_COLOR = GRAY;
+  static constexpr Color GARBAGE_COLOR = {130, 130, 130, 255};
+  static constexpr Color INCOMING_GARBAGE_COLOR = RED;
   static constexpr Color TETRION_BACKGROUND_COLOR = BLACK;
   static constexpr Color GRINDLINE_COLOR = DARKGRAY;
   static constexpr Color UNAVAILABLE_HOLD_PIECE_COLOR = DARKGRAY;
@@ -0,0 +1,65 @@
+#ifndef EVALUATOR_HPP
+#define EVALUATOR_HPP
+
+#include "Grid.hpp"
+#include <span>
+
+// What a bot looks at to judge a board. Heights are counted from the floor,
+// and the walls and floor count as filled cells everywhere.
+struct BoardFeatures {
+  std::array<std::uint8_t, Grid::WIDTH> heights;
+  int aggregate_height;
+  int max_height;
+  // Empty cells with a filled cell somewhere above them
+  int holes;
+  // Height differences between neighbouring columns
+  int bumpiness;
+  // How far each column is below both of its neighbours, summed
+  int wells;
+  // Changes between filled and empty cells along every row with a filled cell
+  int row_transitions;
+  // Three empty cells over a single one between two filled cells, with a
+  // filled cell over a corner, the shape a T locks into with a spin
+  int t_slots;
+  // Rows missing a single cell that can be reached from above
+  int ready_rows;
+  // Rows the placement cleared, 0 for a board on its own
+  int cleared_rows;
+
+  bool operator==(const BoardFeatures&) const = default;
+};
+
+// Fixed point, so scores, and the bots comparing them, come out the same on
+// every platform and instruction set
+struct EvaluationWeights {
+  int aggregate_height = -51;
+  int max_height = -20;
+  int holes = -356;
+  int bumpiness = -18;
+  int wells = -10;
+  int row_transitions = -32;
+  int t_slots = 60;
+  int ready_rows = 20;
+  int cleared_rows = 76;
+};
+
+// Row masks of a whole board, top row first
+using BoardRows = std::span<const Grid::RowMask, Grid::HEIGHT>;
+
+// The features are found for all rows at once in 16 bit lanes, with AVX2 or
+// SSE2 when the build targets them and with plain loops otherwise. Every
+// instruction set gives the same features.
+BoardFeatures board_features(BoardRows);
+BoardFeatures board_features(const Grid&);
+// The board the piece leaves by locking where it is, after its line clears,
+// found without copying the grid
+BoardFeatures board_features(const Grid&, const FallingPiece&);
+// Always the plain loops, what the vectorized versions are checked against in
+// tests/EvaluatorTest.cpp and measured against in the benchmarks
+BoardFeatures scalar_board_features(BoardRows);
+// "AVX2", "SSE2" or "scalar"
+extern const char* const BOARD_FEATURES_ISA;
+
+int evaluate(const BoardFeatures&, const EvaluationWeights& = {});
+
+#endif
@@ -3,6 +3,9 @@
 
 #include <array>
 
+class BitWriter;
+class BitReader;
+
 enum class Tetromino : unsigned char {
   I,
   O,
@@ -57,8 +60,8 @@ struct FallingPiece {
   FallingPiece shifted(Shift) const;
   FallingPiece rotated(RotationType) const;
   FallingPiece translated(CoordinatePair translation) const;
+  void save(BitWriter&) const;
+  void load(BitReader&);
 };
 
-const OffsetTable& offset_table(const FallingPiece&);
-
 #endif
@@ -0,0 +1,36 @@
+#ifndef FIXED_TIMESTEP_HPP
+#define FIXED_TIMESTEP_HPP
+
+#include <chrono>
+
+#ifndef RAYTRIS_TICK_RATE
+#define RAYTRIS_TICK_RATE 60
+#endif
+
+// Turns wall clock time into whole simulation ticks at a fixed rate, carrying
+// what is left of a tick over to the next frame, so gravity, DAS and lock
+// delay run at the same speed however fast or unevenly frames are drawn.
+class FixedTimestep {
+public:
+  using Clock = std::chrono::steady_clock;
+  static constexpr int TICK_RATE = RAYTRIS_TICK_RATE;
+  static constexpr Clock::duration TICK =
+    std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) /
+    TICK_RATE;
+  // Longer stalls are dropped instead of caught up on, otherwise a slow frame
+  // would leave the next one with even more ticks to run
+  static constexpr int MAX_TICKS_PER_FRAME = 8;
+
+private:
+  Clock::time_point last;
+  Clock::duration accumulated{0};
+
+public:
+  FixedTimestep(Clock::time_point now = Clock::now());
+  // The number of ticks due since the last call
+  int advance(Clock::time_point now = Clock::now());
+  // When the next tick will be due
+  Clock::time_point next_tick() const;
+};
+
+#endif
@@ -1,17 +1,45 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
+#include "BotController.hpp"
+#include "HudText.hpp"
+#include "KeyboardController.hpp"
 #include "Playfield.hpp"
+#include "PlayfieldRenderer.hpp"
+#include "Replay.hpp"
+#include <optional>
 
 struct Game {
   const DrawingDetails drawing_details;
-  const Controller controller;
+  const PlayfieldRenderer renderer;
+  KeyboardController controller;
   const HandlingSettings settings;
   Playfield playfield;
+  // Inputs of the last tick
+  Inputs inputs;
   bool paused = false;
+  std::optional<ReplayWriter> recorder;
+  // Plays instead of the keyboard when set
+  std::optional<BotController> bot;
+  const HudLabel lost_label{"YOU LOST"};
+  const HudLabel paused_label{"GAME PAUSED"};
+  const HudLabel quit_label{"Press Esc to quit"};
 
-  Game(const DrawingDetails&, const Controller&, const HandlingSettings&);
+  Game(
+    const DrawingDetails&,
+    const KeyboardController::Bindings&,
+    const HandlingSettings&
+  );
+  ~Game();
+  // Records every frame from now on, restarts begin a new recording
+  void record(const std::string&);
   void draw() const;
+  // Hands the game to a bot from now on
+  void play_bot(const BotSettings&);
+  // Reads the key events that arrived before this tick into inputs, or asks
+  // the bot for them
+  void poll(std::span<const KeyEvent>);
+  // One simulation tick on the polled inputs
   bool update();
 };
 
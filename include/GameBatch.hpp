@@ -0,0 +1,62 @@
+#ifndef GAME_BATCH_HPP
+#define GAME_BATCH_HPP
+
+#include "Playfield.hpp"
+#include "ThreadPool.hpp"
+#include <span>
+#include <vector>
+
+// Steps many independent games at once for self-play. Actions come in as one
+// Inputs per game and observations go out as flat arrays, one per field and
+// indexed by game, so a trainer can wrap them without copying. Games that top
+// out are restarted in the same step and flagged in done().
+class GameBatch {
+public:
+  struct PiecePose {
+    Tetromino tetromino;
+    Orientation orientation;
+    signed char x;
+    signed char y;
+  };
+
+  static constexpr std::size_t GRID_ROWS = Grid::HEIGHT;
+  static constexpr std::size_t QUEUE_SIZE = NextQueue::NEXT_SIZE;
+
+private:
+  HandlingSettings settings;
+  std::vector<Playfield> playfields;
+  std::vector<Grid::RowMask> grid_rows;
+  std::vector<Tetromino> queue_pieces;
+  std::vector<Tetromino> hold_pieces;
+  std::vector<PiecePose> piece_poses;
+  std::vector<std::uint32_t> step_rewards;
+  std::vector<std::uint8_t> step_done;
+
+  void observe(std::size_t);
+  void observe_piece(std::size_t);
+  void step_game(std::size_t, Inputs);
+
+public:
+  GameBatch(std::size_t, std::uint64_t seed, const HandlingSettings& = {});
+  std::size_t size() const;
+  // Advances every game one frame, actions[i] drives game i
+  void step(std::span<const Inputs> actions);
+  // Same as above with the games sharded across the pool's workers
+  void step(std::span<const Inputs> actions, ThreadPool&);
+  // Starts every game over with a fresh seed
+  void reset();
+  const Playfield& operator[](std::size_t) const;
+
+  // size() * GRID_ROWS row masks, top row first
+  std::span<const Grid::RowMask> grids() const;
+  // size() * QUEUE_SIZE upcoming pieces
+  std::span<const Tetromino> queues() const;
+  std::span<const Tetromino> holds() const;
+  std::span<const PiecePose> pieces() const;
+  // Score gained during the last step
+  std::span<const std::uint32_t> rewards() const;
+  // 1 for games that topped out during the last step and were restarted
+  std::span<const std::uint8_t> done() const;
+};
+
+#endif
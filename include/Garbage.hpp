@@ -0,0 +1,41 @@
+#ifndef GARBAGE_HPP
+#define GARBAGE_HPP
+
+#include <array>
+#include <cstdint>
+
+class BitWriter;
+class BitReader;
+
+// Lines of garbage sent by one lock, all with the same empty column
+struct GarbageAttack {
+  std::uint8_t lines;
+  std::uint8_t hole;
+};
+
+// Attacks waiting to rise into a playfield, oldest first. Lines the player
+// sends cancel them before reaching anyone else, and whatever is left rises
+// once a piece locks without clearing a line.
+class GarbageQueue {
+  static constexpr std::size_t CAPACITY = 16;
+
+  std::array<GarbageAttack, CAPACITY> attacks{};
+  std::uint8_t first = 0;
+  std::uint8_t count = 0;
+  unsigned int total = 0;
+
+public:
+  bool empty() const;
+  // Lines waiting in every attack together
+  unsigned int lines() const;
+  // When full, the lines are added to the newest attack instead
+  void push(GarbageAttack);
+  // Cancels up to lines, oldest first, and returns the lines left over
+  unsigned int cancel(unsigned int lines);
+  // Takes at most max_lines off the oldest attack
+  GarbageAttack pop(unsigned int max_lines);
+  void save(BitWriter&) const;
+  void load(BitReader&);
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef GRID_HPP
+#define GRID_HPP
+
+#include "FallingPiece.hpp"
+#include <cstdint>
+#include <span>
+
+// Locked cells of a playfield. Colors are kept for drawing, while every row
+// also has an occupancy bitmask (bit x set means column x is filled) so
+// collision and full-row checks never touch individual cells. The highest
+// filled row is tracked too, which bounds line clears and makes the all-clear
+// check O(1). Columns get bitmasks as well (bit y set means row y is filled),
+// so how far a piece can fall is found without stepping it down, the same way
+// row masks tell how far it can shift. A Zobrist hash of the filled cells is
+// updated along with them.
+class Grid {
+public:
+  static constexpr std::size_t WIDTH = 10;
+  static constexpr std::size_t HEIGHT = 40;
+
+  using RowMask = std::uint16_t;
+  static constexpr RowMask EMPTY_ROW = 0;
+  static constexpr RowMask FULL_ROW = (1u << WIDTH) - 1;
+
+  // Bit HEIGHT is always set and stands for the floor
+  using ColumnMask = std::uint64_t;
+  static constexpr ColumnMask FLOOR = ColumnMask{1} << HEIGHT;
+  static_assert(HEIGHT < 64);
+
+  Grid();
+  // Empty for garbage too, which fills cells without being any tetromino
+  Tetromino at(int x, int y) const;
+  // Cells outside the grid count as occupied
+  bool occupied(int x, int y) const;
+  RowMask row_mask(std::size_t y) const;
+  // Every row mask, top row first
+  std::span<const RowMask, HEIGHT> row_masks() const;
+  ColumnMask column_mask(std::size_t x) const;
+  // Bumped on every change, so derived state can tell when it is stale
+  std::uint32_t revision() const;
+  // Zobrist hash of the filled cells, kept up to date by every change. Equal
+  // stacks hash the same whatever their colors.
+  std::uint64_t hash() const;
+  bool fits(const FallingPiece&) const;
+  // Rows the piece can fall before it lands
+  int drop_distance(const FallingPiece&) const;
+  // Columns the piece can shift before it hits a wall or the stack
+  int shift_distance(const FallingPiece&, Shift) const;
+  void place(const FallingPiece&);
+  // Clears the full rows among the ones the piece covers and returns how
+  // many there were
+  int clear_full_rows(const FallingPiece&);
+  // Pushes the whole stack up and fills the bottom rows but for the hole
+  // column. Returns false when filled cells were pushed out of the top.
+  bool insert_garbage(int lines, int hole);
+  bool empty() const;
+  void save(BitWriter&) const;
+  void load(BitReader&);
+  // Same cells and colors, however many changes it took to get there
+  bool operator==(const Grid&) const;
+
+private:
+  std::array<std::array<Tetromino, WIDTH>, HEIGHT> cells;
+  std::array<RowMask, HEIGHT> rows;
+  std::array<ColumnMask, WIDTH> columns;
+  // Index of the highest row with a filled cell, HEIGHT when empty
+  std::size_t stack_top = HEIGHT;
+  std::uint32_t changes = 0;
+  std::uint64_t zobrist = 0;
+
+  void rehash();
+};
+
+#endif
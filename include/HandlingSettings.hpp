@@ -1,12 +1,28 @@
 #ifndef HANDLING_SETTINGS_HPP
 #define HANDLING_SETTINGS_HPP
 
+#include <cstdint>
+
+class BitWriter;
+class BitReader;
+
+// Every duration is counted in simulation ticks
 struct HandlingSettings {
-  int gravity;
-  int soft_drop;
-  int lock_delay_frames;
-  int lock_delay_resets;
-  int das;
+  int gravity = 20;
+  int soft_drop = 1;
+  int lock_delay_frames = 30;
+  int lock_delay_resets = 15;
+  int das = 7;
+  // Auto repeat rate, ticks between auto shifts, 0 goes straight to the wall
+  int arr = 0;
+  // DAS cut delay, ticks auto shift holds off after a rotation or a new piece
+  int dcd = 0;
+  // Soft drop factor, rows per soft drop step, 0 goes straight to the floor
+  int sdf = 1;
+
+  void save(BitWriter&) const;
+  // version is the save file's, settings it predates keep their defaults
+  void load(BitReader&, std::uint16_t version);
 };
 
 #endif
@@ -0,0 +1,71 @@
+#ifndef HUD_TEXT_HPP
+#define HUD_TEXT_HPP
+
+#include <array>
+#include <format>
+#include <optional>
+#include <tuple>
+
+// raylib's MeasureText, defined by the frontend so the HUD text types build
+// without raylib
+int measure_text(const char* text, int font_size);
+
+// A constant string, measured once for every font size it is drawn at
+class HudLabel {
+  const char* text;
+  mutable int measured_font_size = -1;
+  mutable int measured_width = 0;
+
+public:
+  HudLabel(const char* _text = "") : text(_text) {}
+
+  const char* c_str() const {
+    return text;
+  }
+
+  int width(int font_size) const {
+    if (font_size != measured_font_size) {
+      measured_font_size = font_size;
+      measured_width = measure_text(text, font_size);
+    }
+    return measured_width;
+  }
+};
+
+// Text built from values that change now and then, like the score. It is only
+// formatted, into a fixed buffer, when the values differ from the last ones,
+// so drawing it every frame does not allocate.
+template <typename... Values>
+class HudText {
+  static constexpr std::size_t CAPACITY = 32;
+
+  std::format_string<const Values&...> format;
+  std::optional<std::tuple<Values...>> values;
+  std::array<char, CAPACITY> buffer{};
+  HudLabel label;
+
+public:
+  HudText(std::format_string<const Values&...> _format) : format(_format) {}
+  // The label points into this buffer
+  HudText(const HudText&) = delete;
+  HudText& operator=(const HudText&) = delete;
+
+  const char* c_str(const Values&... new_values) {
+    if (values != std::tuple<Values...>(new_values...)) {
+      values.emplace(new_values...);
+      auto end = std::format_to_n(
+        buffer.data(), CAPACITY - 1, format, new_values...
+      );
+      *end.out = '\0';
+      label = HudLabel(buffer.data());
+    }
+    return buffer.data();
+  }
+
+  // Width of the text last returned by c_str()
+  int width(int font_size) const {
+    return label.width(font_size);
+  }
+};
+
+#endif
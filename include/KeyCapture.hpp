@@ -0,0 +1,27 @@
+#ifndef KEY_CAPTURE_HPP
+#define KEY_CAPTURE_HPP
+
+#include "KeyboardController.hpp"
+#include "SpscQueue.hpp"
+
+using KeyEventQueue = SpscQueue<KeyEvent, 256>;
+
+// Pushes every key press and release into a queue as the window system
+// delivers it, ahead of raylib, which only keeps the last state of each key
+// per poll. Only one can exist at a time, as the window has one callback.
+class KeyCapture {
+  KeyEventQueue& queue;
+  bool hooked = false;
+
+public:
+  // Needs the window to be open already
+  KeyCapture(KeyEventQueue&);
+  KeyCapture(const KeyCapture&) = delete;
+  KeyCapture& operator=(const KeyCapture&) = delete;
+  ~KeyCapture();
+  // Where the window callback can not be hooked (the web build) it pushes
+  // the keys raylib saw change in the last poll instead, once per frame
+  void sample();
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef KEYBOARD_CONTROLLER_HPP
+#define KEYBOARD_CONTROLLER_HPP
+
+#include "Controller.hpp"
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <span>
+
+// A key going down or up, stamped with the time it was delivered
+struct KeyEvent {
+  int key;
+  bool down;
+  std::chrono::steady_clock::time_point time;
+};
+
+// Fires while modifier is down too, unless modifier is 0
+struct KeyBinding {
+  int key = 0;
+  int modifier = 0;
+};
+
+// Turns the key events that arrived before a tick into that tick's Inputs,
+// so a key pressed and released between two ticks is not lost. Presses fire
+// on exactly one tick, held actions stay on as long as their key is down.
+class KeyboardController {
+public:
+  // Key codes are below raylib's MAX_KEYBOARD_KEYS
+  static constexpr int KEYS = 512;
+  // One binding per Action, in Action order, key 0 is unbound
+  using Bindings = std::array<KeyBinding, Inputs::BITS>;
+
+private:
+  Bindings bindings;
+  std::bitset<KEYS> down;
+
+public:
+  KeyboardController(const Bindings&);
+  Inputs tick(std::span<const KeyEvent>);
+};
+
+#endif
@@ -1,19 +1,28 @@
 #ifndef MENU_H
 #define MENU_H
 
+#include "HudText.hpp"
+#include <array>
+#include <utility>
+
 class MainMenu {
 public:
   enum class Option {
     SinglePlayer,
     TwoPlayers,
+    VersusCpu,
+    Replay,
     Settings,
     Exit
   };
 
 private:
   Option selectedOption = Option::SinglePlayer;
+  const HudLabel title{"RAYTRIS"};
+  std::array<HudLabel, std::to_underlying(Option::Exit)> option_labels;
 
 public:
+  MainMenu();
   void draw() const;
   void update();
   bool should_stop_running() const;
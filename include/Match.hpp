@@ -0,0 +1,62 @@
+#ifndef MATCH_HPP
+#define MATCH_HPP
+
+#include "Playfield.hpp"
+#include "Random.hpp"
+#include "ThreadPool.hpp"
+#include <functional>
+#include <span>
+#include <vector>
+
+// Any number of boards playing versus under the same attack rules. A step
+// updates every board still standing and only then hands out what they
+// sent, each board attacking the next one standing, so the order boards are
+// listed in never matters. Garbage holes come from the match's own
+// generator, the seed and the inputs replay a match exactly.
+class Match {
+  HandlingSettings settings;
+  std::vector<Playfield> boards;
+  Pcg32 holes;
+  std::uint64_t frames = 0;
+  std::size_t standing;
+
+public:
+  Match(std::size_t players, std::uint64_t seed, const HandlingSettings& = {});
+  std::size_t size() const;
+  const Playfield& operator[](std::size_t) const;
+  // Advances every board one frame, inputs[i] drives board i
+  void step(std::span<const Inputs> inputs);
+  // Frames stepped so far
+  std::uint64_t frame_count() const;
+  // Whether at most one board is left
+  bool over() const;
+  // The last board standing, size() while undecided or after a draw
+  std::size_t winner() const;
+
+  // Hands the lines from sent in its last update to to
+  static void send(const Playfield& from, Playfield& to, Pcg32& holes);
+};
+
+struct MatchResult {
+  std::size_t winner;
+  std::uint64_t frames;
+};
+
+// Picks a board's inputs for the next frame. A match is played on a single
+// worker from start to end, so per-match state in the caller needs no lock.
+using MatchPolicy =
+  std::function<Inputs(std::size_t match, const Match&, std::size_t board)>;
+
+// Schedules whole matches over the pool's workers and plays each of them
+// until it is over or reaches max_frames. Match i is seeded with seed + i.
+std::vector<MatchResult> play_matches(
+  ThreadPool&,
+  std::size_t matches,
+  std::size_t players,
+  std::uint64_t seed,
+  std::uint64_t max_frames,
+  const MatchPolicy&,
+  const HandlingSettings& = {}
+);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef MINO_ATLAS_HPP
+#define MINO_ATLAS_HPP
+
+#include "FallingPiece.hpp"
+#include "raylib.h"
+#include <utility>
+
+// Every look a mino can have, the first seven in Tetromino order
+enum class MinoStyle : unsigned char {
+  I,
+  O,
+  T,
+  Z,
+  S,
+  J,
+  L,
+  Garbage,
+  Ghost,
+  Unavailable,
+  Danger,
+};
+
+MinoStyle mino_style(Tetromino);
+
+// All mino styles baked into one texture for a block length. Minos drawn
+// between begin() and end() are textured quads from the same texture, which
+// raylib batches into a single draw call.
+class MinoAtlas {
+  static constexpr int STYLES = std::to_underlying(MinoStyle::Danger) + 1;
+
+  float block_length;
+  // Cells are a pixel apart so neighbours never bleed into each other
+  float stride;
+  Texture2D texture;
+
+public:
+  MinoAtlas(float block_length);
+  MinoAtlas(const MinoAtlas&) = delete;
+  MinoAtlas& operator=(const MinoAtlas&) = delete;
+  ~MinoAtlas();
+  void begin() const;
+  void draw(MinoStyle, Vector2 position) const;
+  void end() const;
+};
+
+#endif
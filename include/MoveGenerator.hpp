@@ -0,0 +1,93 @@
+#ifndef MOVE_GENERATOR_HPP
+#define MOVE_GENERATOR_HPP
+
+#include "Playfield.hpp"
+#include <bitset>
+#include <span>
+#include <vector>
+
+// Finds every placement a piece can lock into from where it is, following
+// Playfield's movement rules: single shifts, SRS rotations with kicks, soft
+// drops to the floor (so tucks and spins under overhangs are found) and a
+// final hard drop. Placements covering the same cells with the same spin are
+// reported once, with the fewest moves. Moving around in mid air below the
+// starting row is not searched, and neither are gravity or the lock delay
+// reset limit, a bot is expected to play the inputs out faster.
+//
+// The generator keeps its buffers between calls, sized for the most nodes and
+// placements a search can find, so reusing one per thread never allocates.
+class MoveGenerator {
+public:
+  enum class Move : unsigned char {
+    Left,
+    Right,
+    Clockwise,
+    CounterClockwise,
+    OneEighty,
+    SoftDrop,
+    HardDrop,
+  };
+
+  struct Placement {
+    FallingPiece piece;
+    SpinType spin;
+    std::uint16_t node;
+  };
+  // Most placements one call can report, one per (top, left, orientation,
+  // spin). Far more than any real board has, but nothing lower is certain.
+  static constexpr std::size_t MAX_PLACEMENTS =
+    Grid::HEIGHT * Grid::WIDTH * 4 * 3;
+
+private:
+  // Grid rows with walls, a floor and a ceiling of filled cells around them,
+  // so collision is a shift and an AND without any bounds checks
+  static constexpr int PADDING = 4;
+  static constexpr int WALL = 5;
+  using Board = std::array<std::uint32_t, Grid::HEIGHT + 2 * PADDING>;
+
+  static constexpr int X_OFFSET = 2;
+  static constexpr int Y_OFFSET = 2;
+  static constexpr int X_RANGE = Grid::WIDTH + 2 * X_OFFSET;
+  static constexpr int Y_RANGE = Grid::HEIGHT + 2 * Y_OFFSET;
+  static constexpr std::uint16_t NO_PARENT = 0xFFFF;
+
+  struct Node {
+    signed char x;
+    signed char y;
+    Orientation orientation;
+    bool rotated;
+    Move move;
+    std::uint16_t parent;
+  };
+
+  Tetromino tetromino;
+  Board board;
+  std::array<Grid::ColumnMask, Grid::WIDTH> columns;
+  std::vector<Node> nodes;
+  // One bit per (x, y, orientation, last move was a rotation)
+  std::bitset<X_RANGE * Y_RANGE * 4 * 2> visited;
+  // One bit per (top, left, orientation, spin) of a reported placement
+  std::bitset<MAX_PLACEMENTS> placed;
+  std::vector<Placement> placements;
+
+  bool fits(int x, int y, Orientation) const;
+  int landing_row(const Node&) const;
+  void visit(Node);
+  FallingPiece piece(const Node&) const;
+  void add_placement(const Node&, SpinType, std::uint16_t);
+
+public:
+  MoveGenerator();
+  std::span<const Placement> generate(const Grid&, const FallingPiece&);
+  // Moves from the generated piece to the placement, one per frame, ending in
+  // a hard drop. Only valid until the next call to generate.
+  std::vector<Move> moves(const Placement&) const;
+  // The same moves as Inputs ready for Playfield::update, soft drops held
+  // for as many frames as the settings need to reach the floor. Written over
+  // result, so a bot reusing its vector does not allocate once it has grown.
+  void inputs(
+    const Placement&, const HandlingSettings&, std::vector<Inputs>& result
+  ) const;
+};
+
+#endif
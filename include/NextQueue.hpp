@@ -2,21 +2,78 @@
 #define NEXT_QUEUE_H
 
 #include "FallingPiece.hpp"
+#include "Random.hpp"
 
-class NextQueue {
+// Randomizer policies. Each one owns whatever state it needs besides the
+// queue's RNG and hands out one tetromino per call to next().
+template <std::size_t COPIES>
+class Bag {
+public:
+  static constexpr std::size_t SIZE = COPIES * std::size_t{7};
+
+private:
+  std::array<Tetromino, SIZE> bag;
+  unsigned char remaining = 0;
+
+public:
+  Tetromino next(Pcg32&);
+  void save(BitWriter&) const;
+  void load(BitReader&);
+};
+
+using SevenBag = Bag<1>;
+using FourteenBag = Bag<2>;
+
+class ClassicRandom {
+public:
+  Tetromino next(Pcg32&);
+  void save(BitWriter&) const;
+  void load(BitReader&);
+};
+
+// TGM2 style: reroll up to ROLLS times while the piece is in the history of
+// the last four, and never start with S, Z or O
+class TgmHistory {
+public:
+  static constexpr int ROLLS = 6;
+
+private:
+  std::array<Tetromino, 4> history = {
+    Tetromino::Z, Tetromino::S, Tetromino::S, Tetromino::Z
+  };
+  bool first = true;
+
+public:
+  Tetromino next(Pcg32&);
+  void save(BitWriter&) const;
+  void load(BitReader&);
+};
+
+template <class Randomizer>
+class BasicNextQueue {
 public:
   static constexpr std::size_t NEXT_SIZE = 5;
-  static constexpr std::size_t SIZE_OF_BAG = 7;
-  static constexpr std::size_t MAX_QUEUE_SIZE = NEXT_SIZE + SIZE_OF_BAG;
 
 private:
-  std::array<Tetromino, MAX_QUEUE_SIZE> queue;
-  std::size_t queue_size;
+  Pcg32 generator;
+  Randomizer randomizer;
+  std::array<Tetromino, NEXT_SIZE> queue;
+  unsigned char front = 0;
 
 public:
-  NextQueue();
+  BasicNextQueue(std::uint64_t seed = random_seed());
   Tetromino next_tetromino();
   const Tetromino& operator[](std::size_t index) const;
+  // Draws a seed from the queue's RNG, e.g. to restart deterministically
+  std::uint64_t next_seed();
+  void save(BitWriter&) const;
+  void load(BitReader&);
 };
 
+#ifndef RAYTRIS_RANDOMIZER
+#define RAYTRIS_RANDOMIZER SevenBag
+#endif
+
+using NextQueue = BasicNextQueue<RAYTRIS_RANDOMIZER>;
+
 #endif
@@ -0,0 +1,167 @@
+#ifndef PIECE_TABLES_HPP
+#define PIECE_TABLES_HPP
+
+#include "FallingPiece.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+// Everything about a piece that only depends on its tetromino and orientation,
+// built at compile time so rotating and collision checks are table lookups.
+namespace piece_tables {
+constexpr std::size_t TETROMINOES = std::to_underlying(Tetromino::Empty) + 1;
+constexpr std::size_t ORIENTATIONS = 4;
+constexpr std::size_t ROTATION_TYPES = 3;
+
+// Row masks of a piece relative to its center. Bit (coord.x + MASK_ORIGIN) is
+// set for every mino, so shifting by (piece.x - MASK_ORIGIN) lines the mask up
+// with the grid columns.
+constexpr int MASK_ORIGIN = 2;
+
+struct PieceMask {
+  std::array<std::uint16_t, 4> rows;
+  signed char top;
+  signed char height;
+  signed char left;
+  signed char right;
+};
+
+struct Rotation {
+  Orientation orientation;
+  TetrominoMap map;
+  // SRS kicks in the order they are tried, already resolved from the offset
+  // tables of both orientations
+  OffsetTable kicks;
+};
+
+constexpr std::array<TetrominoMap, TETROMINOES> SPAWN_MAPS = {{
+  /* I */ {{{-1, 0}, {0, 0}, {1, 0}, {2, 0}}},
+  /* O */ {{{0, -1}, {1, -1}, {0, 0}, {1, 0}}},
+  /* T */ {{{0, -1}, {-1, 0}, {0, 0}, {1, 0}}},
+  /* Z */ {{{-1, -1}, {0, -1}, {0, 0}, {1, 0}}},
+  /* S */ {{{0, -1}, {1, -1}, {-1, 0}, {0, 0}}},
+  /* J */ {{{-1, -1}, {-1, 0}, {0, 0}, {1, 0}}},
+  /* L */ {{{1, -1}, {-1, 0}, {0, 0}, {1, 0}}},
+  /* Empty */ {{{0, 0}, {0, 0}, {0, 0}, {0, 0}}},
+}};
+
+using OrientationOffsets = std::array<OffsetTable, ORIENTATIONS>;
+
+constexpr OrientationOffsets I_OFFSETS = {{
+  {{{0, 0}, {-1, 0}, {2, 0}, {-1, 0}, {2, 0}}},
+  {{{-1, 0}, {0, 0}, {0, 0}, {0, -1}, {0, 2}}},
+  {{{-1, -1}, {1, -1}, {-2, -1}, {1, 0}, {-2, 0}}},
+  {{{0, -1}, {0, -1}, {0, -1}, {0, 1}, {0, -2}}},
+}};
+constexpr OrientationOffsets O_OFFSETS = {{
+  {{{0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}}},
+  {{{0, 1}, {0, 1}, {0, 1}, {0, 1}, {0, 1}}},
+  {{{-1, 1}, {-1, 1}, {-1, 1}, {-1, 1}, {-1, 1}}},
+  {{{-1, 0}, {-1, 0}, {-1, 0}, {-1, 0}, {-1, 0}}},
+}};
+constexpr OrientationOffsets DEFAULT_OFFSETS = {{
+  {{{0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}}},
+  {{{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}}},
+  {{{0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}}},
+  {{{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}}},
+}};
+
+constexpr const OrientationOffsets& offsets(Tetromino tetromino) {
+  return tetromino == Tetromino::I ? I_OFFSETS :
+    tetromino == Tetromino::O      ? O_OFFSETS :
+                                     DEFAULT_OFFSETS;
+}
+
+constexpr TetrominoMap rotate_clockwise(TetrominoMap map) {
+  for (auto& coord : map)
+    coord = {static_cast<signed char>(-coord.y), coord.x};
+  return map;
+}
+
+constexpr int steps(RotationType rotation_type) {
+  switch (rotation_type) {
+  case RotationType::Clockwise:
+    return 1;
+  case RotationType::CounterClockwise:
+    return 3;
+  case RotationType::OneEighty:
+    return 2;
+  }
+  return 0;
+}
+
+constexpr PieceMask make_mask(const TetrominoMap& map) {
+  PieceMask mask{{}, 2, 0, 2, -2};
+  signed char bottom = -2;
+  for (auto coord : map) {
+    mask.top = std::min<signed char>(mask.top, coord.y);
+    bottom = std::max<signed char>(bottom, coord.y);
+    mask.left = std::min<signed char>(mask.left, coord.x);
+    mask.right = std::max<signed char>(mask.right, coord.x);
+  }
+  mask.height = bottom - mask.top + 1;
+  for (auto coord : map)
+    mask.rows[coord.y - mask.top] |= 1u << (coord.x + MASK_ORIGIN);
+  return mask;
+}
+
+inline constexpr auto MAPS = [] {
+  std::array<std::array<TetrominoMap, ORIENTATIONS>, TETROMINOES> maps{};
+  for (std::size_t t = 0; t < TETROMINOES; t++) {
+    maps[t][0] = SPAWN_MAPS[t];
+    for (std::size_t o = 1; o < ORIENTATIONS; o++)
+      maps[t][o] = rotate_clockwise(maps[t][o - 1]);
+  }
+  return maps;
+}();
+
+inline constexpr auto MASKS = [] {
+  std::array<std::array<PieceMask, ORIENTATIONS>, TETROMINOES> masks{};
+  for (std::size_t t = 0; t < TETROMINOES; t++)
+    for (std::size_t o = 0; o < ORIENTATIONS; o++)
+      masks[t][o] = make_mask(MAPS[t][o]);
+  return masks;
+}();
+
+inline constexpr auto ROTATIONS = [] {
+  std::array<
+    std::array<std::array<Rotation, ROTATION_TYPES>, ORIENTATIONS>,
+    TETROMINOES>
+    rotations{};
+  for (std::size_t t = 0; t < TETROMINOES; t++) {
+    const auto& table = offsets(static_cast<Tetromino>(t));
+    for (std::size_t from = 0; from < ORIENTATIONS; from++) {
+      for (std::size_t r = 0; r < ROTATION_TYPES; r++) {
+        auto to = (from + steps(static_cast<RotationType>(r))) % ORIENTATIONS;
+        Rotation& rotation = rotations[t][from][r];
+        rotation.orientation = static_cast<Orientation>(to);
+        rotation.map = MAPS[t][to];
+        for (std::size_t k = 0; k < rotation.kicks.size(); k++)
+          rotation.kicks[k] = {
+            static_cast<signed char>(table[from][k].x - table[to][k].x),
+            static_cast<signed char>(table[from][k].y - table[to][k].y)
+          };
+      }
+    }
+  }
+  return rotations;
+}();
+
+constexpr const TetrominoMap&
+map(Tetromino tetromino, Orientation orientation) {
+  return MAPS[std::to_underlying(tetromino)][std::to_underlying(orientation)];
+}
+
+constexpr const PieceMask&
+mask(Tetromino tetromino, Orientation orientation) {
+  return MASKS[std::to_underlying(tetromino)][std::to_underlying(orientation)];
+}
+
+constexpr const Rotation&
+rotation(Tetromino tetromino, Orientation from, RotationType rotation_type) {
+  return ROTATIONS[std::to_underlying(tetromino)][std::to_underlying(from)]
+                  [std::to_underlying(rotation_type)];
+}
+} // namespace piece_tables
+
+#endif
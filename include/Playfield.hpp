@@ -2,7 +2,8 @@
 #define PLAYFIELD_H
 
 #include "Controller.hpp"
-#include "DrawingDetails.hpp"
+#include "Garbage.hpp"
+#include "Grid.hpp"
 #include "HandlingSettings.hpp"
 #include "NextQueue.hpp"
 
@@ -21,6 +22,17 @@ enum class SpinType {
   Proper,
 };
 
+// Spin a piece locking in place would score, assuming its last move was a
+// rotation. Only T pieces spin, by the 3-corner rule.
+SpinType is_spin(const FallingPiece&, const Grid&);
+
+// Garbage lines a lock sends, given the combo and back to back counts it
+// leaves behind
+unsigned int attack_lines(
+  int cleared_lines, SpinType, unsigned int combo, unsigned int b2b,
+  bool all_clear
+);
+
 struct LineClearMessage {
   static constexpr unsigned char DURATION = 180;
 
@@ -38,46 +50,117 @@ struct LineClearMessage {
     spin_type(SpinType::No) {}
 };
 
+// What one locked piece changed: the placement plus the scalar state after it.
+// Replaying it on the playfield it was taken from rebuilds the locked state, so
+// undo history and autosaves keep these instead of whole Playfield copies.
+// Garbage is not part of it, versus playfields are never rebuilt from locks.
+// Most of it is the NextQueue, so its size follows RAYTRIS_RANDOMIZER: 72
+// bytes with SevenBag, 80 with FourteenBag, against 768 for a Playfield.
+struct PieceLock {
+  FallingPiece locked_piece;
+  Tetromino spawned_piece;
+  Tetromino holding_piece;
+  bool has_lost;
+  LineClearMessage message;
+  unsigned int combo;
+  unsigned int b2b;
+  unsigned long score;
+  NextQueue next_queue;
+
+  void save(BitWriter&) const;
+  void load(BitReader&);
+};
+
 class Playfield {
 public:
-  static constexpr std::size_t WIDTH = 10;
-  static constexpr std::size_t HEIGHT = 40;
+  static constexpr std::size_t WIDTH = Grid::WIDTH;
+  static constexpr std::size_t HEIGHT = Grid::HEIGHT;
   static constexpr std::size_t VISIBLE_HEIGHT = 20;
+  static constexpr std::size_t INITIAL_X_POSITION = (WIDTH - 1) / 2;
+  static constexpr std::size_t INITIAL_Y_POSITION = VISIBLE_HEIGHT - 1;
+  // Most garbage lines that rise after a single lock
+  static constexpr unsigned int GARBAGE_CAP = 8;
 
-  Playfield();
+  Playfield(std::uint64_t seed = random_seed());
   bool lost() const;
-  bool update(const Controller&, const HandlingSettings&);
-  void draw(const DrawingDetails&) const;
+  unsigned long get_score() const;
+  // Row the falling piece would land on if dropped
+  int ghost_y() const;
+  // Whether the stack reaches into the middle of the spawn rows
+  bool in_danger() const;
+  bool update(Inputs, const HandlingSettings&);
+  // Lines the last update sent, after cancelling incoming garbage
+  unsigned int attack() const;
+  // Garbage waiting to rise
+  const GarbageQueue& incoming_garbage() const;
+  void receive_garbage(GarbageAttack);
   void restart();
+  PieceLock last_lock() const;
+  bool can_replay(const PieceLock&) const;
+  void replay(const PieceLock&);
+  void save(BitWriter&) const;
+  void load(BitReader&);
+  // Zobrist hash of what the rest of the game depends on: the stack, the
+  // falling piece's tetromino, the preview, the hold, whether it can be used,
+  // combo and back to back. Kept up to date by every change, so telling states
+  // apart costs a compare. Where the piece is, timers, score and garbage are
+  // left out, as is the randomizer past the preview.
+  std::uint64_t hash() const;
+  // Equal when everything the hash covers is, which different hashes rule
+  // out with a single compare
+  bool operator==(const Playfield&) const;
 
 private:
-  std::array<std::array<Tetromino, WIDTH>, HEIGHT> grid;
+  Grid grid;
   NextQueue next_queue;
   FallingPiece falling_piece;
+  FallingPiece locked_piece;
   Tetromino holding_piece = Tetromino::Empty;
   bool can_swap = true;
   unsigned int frames_since_drop = 0;
   unsigned int lock_delay_frames = 0;
   unsigned int lock_delay_resets = 0;
   int frames_pressed = 0;
+  unsigned int das_cut_frames = 0;
   unsigned int combo = 0;
   bool has_lost = false;
   unsigned long score = 0;
   unsigned int b2b = 0;
   bool last_move_rotation = false;
   LineClearMessage message;
+  GarbageQueue incoming;
+  unsigned int sent_lines = 0;
+  // Hash of all but the grid, which keeps its own
+  std::uint64_t state_hash = 0;
+
+  // Read by the renderer every frame, so they are only recomputed once the
+  // falling piece moved or the grid changed since
+  mutable struct {
+    Tetromino tetromino = Tetromino::Empty;
+    Orientation orientation;
+    char x;
+    char y;
+    std::uint32_t grid_revision;
+    int landing_y;
+  } ghost;
+  mutable struct {
+    std::uint32_t grid_revision = 0;
+    bool in_danger = false;
+  } danger;
 
-  void handle_swap(const Controller&);
-  void handle_shifts(const Controller&, const HandlingSettings&);
-  void handle_rotations(const Controller&);
-  bool handle_drops(const Controller&, const HandlingSettings&);
+  void handle_swap(Inputs);
+  void handle_shifts(Inputs, const HandlingSettings&);
+  void handle_rotations(Inputs, const HandlingSettings&);
+  bool handle_drops(Inputs, const HandlingSettings&);
   void solidify_piece();
+  void spawn_next();
+  std::uint64_t pieces_hash() const;
+  std::uint64_t rehash() const;
 
-  void draw_tetrion(const DrawingDetails&) const;
-  void draw_tetrion_pieces(const DrawingDetails&) const;
-  void draw_next_queue(const DrawingDetails&) const;
-  void draw_hold_piece(const DrawingDetails&) const;
-  void draw_info(const DrawingDetails&) const;
+  friend class PlayfieldRenderer;
+  friend class GameBatch;
+  friend class BotController;
+  friend struct SearchState;
 };
 
 #endif
@@ -0,0 +1,42 @@
+#ifndef PLAYFIELD_RENDERER_HPP
+#define PLAYFIELD_RENDERER_HPP
+
+#include "DrawingDetails.hpp"
+#include "HudText.hpp"
+#include "MinoAtlas.hpp"
+#include "Playfield.hpp"
+#include <optional>
+
+class PlayfieldRenderer {
+  const DrawingDetails draw_d;
+  const MinoAtlas atlas;
+  // Background, gridlines and locked cells, only redrawn once the grid's
+  // revision moved on from the one last drawn, or after redraw_stack()
+  RenderTexture2D stack_texture;
+  Vector2 stack_origin;
+  mutable std::optional<std::uint32_t> drawn_revision;
+  const HudLabel combo_label{"COMBO "};
+  const HudLabel b2b_label{"B2B "};
+  mutable HudText<unsigned int> combo_text{"{}"};
+  mutable HudText<unsigned int> b2b_text{"{}"};
+  mutable HudText<unsigned long> score_text{"{:09}"};
+
+  void draw_tetrion(const Playfield&) const;
+  void draw_next_queue() const;
+  void draw_hold_piece() const;
+  void draw_info(const Playfield&) const;
+  void draw_incoming_garbage(const Playfield&) const;
+  void draw_minos(const Playfield&) const;
+
+public:
+  PlayfieldRenderer(const DrawingDetails&);
+  PlayfieldRenderer(const PlayfieldRenderer&) = delete;
+  PlayfieldRenderer& operator=(const PlayfieldRenderer&) = delete;
+  ~PlayfieldRenderer();
+  void draw(const Playfield&) const;
+  // Revisions only tell apart states of the same grid, call this once the
+  // playfield was replaced by a restart, an undo or a load
+  void redraw_stack() const;
+};
+
+#endif
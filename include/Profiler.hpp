@@ -0,0 +1,76 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+// Scoped timers for finding out where a frame goes. They only exist when
+// configured with -DRAYTRIS_PROFILE=ON, otherwise RAYTRIS_PROFILE_SCOPE
+// expands to nothing and none of the profiler is built.
+#ifdef RAYTRIS_PROFILE
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace profiler {
+struct Event {
+  const char* name;
+  std::uint64_t begin_ns;
+  std::uint64_t end_ns;
+  std::uint32_t thread;
+};
+
+struct ScopeStats {
+  const char* name;
+  std::size_t count;
+  std::uint64_t p50_ns;
+  std::uint64_t p99_ns;
+};
+
+struct HeapStats {
+  std::uint64_t allocations;
+  std::uint64_t frees;
+  std::uint64_t bytes;
+};
+
+std::uint64_t now_ns();
+// Small index of the calling thread, in the order threads first record
+std::uint32_t thread_index();
+// Events go into a fixed size ring shared by all threads, overwriting the
+// oldest ones. Recording never blocks.
+void record(const Event&);
+// The events still in the ring, oldest first
+std::vector<Event> events();
+// Percentiles of every scope over the events still in the ring, by name
+std::vector<ScopeStats> summarize();
+// The JSON format chrome://tracing and Perfetto load
+void write_chrome_trace(std::ostream&);
+// What the calling thread got from the global operator new and gave back
+// so far, counted by replacing it. Compare two reads to check a loop never
+// allocates.
+HeapStats heap_stats();
+
+class Scope {
+  const char* name;
+  std::uint64_t begin_ns;
+
+public:
+  explicit Scope(const char* _name) : name(_name), begin_ns(now_ns()) {}
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+  ~Scope() {
+    record({name, begin_ns, now_ns(), thread_index()});
+  }
+};
+} // namespace profiler
+
+#define RAYTRIS_PROFILE_CONCAT_(a, b) a##b
+#define RAYTRIS_PROFILE_CONCAT(a, b) RAYTRIS_PROFILE_CONCAT_(a, b)
+#define RAYTRIS_PROFILE_SCOPE(name)                                            \
+  const profiler::Scope RAYTRIS_PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+
+#else
+
+#define RAYTRIS_PROFILE_SCOPE(name)
+
+#endif
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef PROFILER_OVERLAY_HPP
+#define PROFILER_OVERLAY_HPP
+
+#include "Profiler.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Rolling p50 and p99 of every profiled scope, shown with F3, along with the
+// heap allocations the frames between refreshes made. F4 writes the events
+// still recorded to profile.json, as a Chrome trace.
+class ProfilerOverlay {
+  static constexpr int REFRESH_FRAMES = 30;
+
+  struct Line {
+    const char* name;
+    std::array<char, 16> p50;
+    std::array<char, 16> p99;
+  };
+
+  bool visible = false;
+  int frames_since_refresh = 0;
+  std::vector<Line> lines;
+  // Read after each refresh, so the overlay's own allocations are left out
+  std::uint64_t allocations = profiler::heap_stats().allocations;
+  std::array<char, 48> heap_line{};
+
+public:
+  void update();
+  void draw() const;
+};
+
+#endif
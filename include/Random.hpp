@@ -0,0 +1,30 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+
+class BitWriter;
+class BitReader;
+
+// PCG32 (XSH RR). 16 bytes of state, and unlike the standard distributions
+// its bounded() and the queues' shuffles give the same sequence for a seed
+// on every platform and standard library.
+class Pcg32 {
+  std::uint64_t state;
+  std::uint64_t increment;
+
+public:
+  using result_type = std::uint32_t;
+
+  Pcg32(std::uint64_t seed, std::uint64_t stream = 0);
+  std::uint32_t operator()();
+  // Uniform in [0, bound)
+  std::uint32_t bounded(std::uint32_t bound);
+  std::uint64_t next_seed();
+  void save(BitWriter&) const;
+  void load(BitReader&);
+};
+
+std::uint64_t random_seed();
+
+#endif
@@ -1,17 +1,47 @@
 #ifndef RAYTRIS_H
 #define RAYTRIS_H
 
+#include "FixedTimestep.hpp"
+#include "KeyCapture.hpp"
 #include "MainMenu.hpp"
+#ifdef RAYTRIS_PROFILE
+#include "ProfilerOverlay.hpp"
+#endif
+#include "ReplayGame.hpp"
 #include "SettingsMenu.hpp"
 #include "SinglePlayerGame.hpp"
 #include "TwoPlayerGame.hpp"
+#include <optional>
 #include <variant>
+#include <vector>
 
 class Raytris {
-  std::variant<MainMenu, SinglePlayerGame, TwoPlayerGame, SettingsMenu> raytris;
+  std::variant<
+    MainMenu,
+    SinglePlayerGame,
+    TwoPlayerGame,
+    ReplayGame,
+    SettingsMenu>
+    raytris;
   bool should_stop_running = false;
+  FixedTimestep timestep;
+  KeyEventQueue key_events;
+  std::optional<KeyCapture> key_capture;
+  // The key events of the tick being run
+  std::vector<KeyEvent> tick_events;
+  RenderMode render_mode = RenderMode::VSync;
+  // When the last frame was presented, for the vsync fallback cap
+  FixedTimestep::Clock::time_point last_present;
+#ifdef RAYTRIS_PROFILE
+  ProfilerOverlay profiler_overlay;
+#endif
 
   void handle_stop_runnig(auto&&);
+  void set_render_mode(RenderMode);
+  // Runs the ticks due by now and draws the result, unless it gets skipped
+  void frame();
+  // Keeps vsync mode from spinning on drivers that ignore the swap interval
+  void cap_frame_rate();
 
 public:
   Raytris();
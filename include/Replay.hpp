@@ -0,0 +1,97 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include "Controller.hpp"
+#include "HandlingSettings.hpp"
+#include "Playfield.hpp"
+#include "Serialization.hpp"
+#include <array>
+#include <fstream>
+#include <optional>
+#include <string>
+
+// Replays use the save file framing:
+//   ReplayStart: handling settings and the starting playfield
+//   ReplayInputs: up to RUNS_PER_CHUNK runs of (inputs, frame count)
+//   ReplayEnd: a ReplaySummary of the final state, used for verification
+// Chunks are written as they fill up and read one at a time, so neither side
+// ever holds more than one chunk of a session in memory.
+
+struct ReplaySummary {
+  std::uint64_t frames = 0;
+  std::uint64_t locks = 0;
+  unsigned long score = 0;
+  bool lost = false;
+  // FNV-1a of the serialized final playfield
+  std::uint32_t digest = 0;
+
+  bool operator==(const ReplaySummary&) const = default;
+};
+
+ReplaySummary
+summarize(const Playfield&, std::uint64_t frames, std::uint64_t locks);
+
+class ReplayWriter {
+public:
+  static constexpr std::size_t RUNS_PER_CHUNK = 256;
+
+private:
+  std::string path;
+  HandlingSettings settings;
+  std::ofstream out;
+  std::array<std::pair<Inputs, std::uint64_t>, RUNS_PER_CHUNK> runs;
+  std::size_t chunk_runs = 0;
+  Inputs run_inputs;
+  std::uint64_t run_length = 0;
+  std::uint64_t frames = 0;
+  std::uint64_t locks = 0;
+  BitWriter writer;
+
+  void end_run();
+  void flush_chunk();
+
+public:
+  ReplayWriter(std::string, const HandlingSettings&);
+  ~ReplayWriter();
+  // Starts the file over from the given state
+  void begin(const Playfield&);
+  void record(Inputs, bool locked);
+  void finish(const Playfield&);
+};
+
+class ReplayReader {
+  std::ifstream in;
+  HandlingSettings settings;
+  Playfield start;
+  bool valid = false;
+  save_file::Record chunk;
+  BitReader chunk_reader;
+  std::uint64_t chunk_runs = 0;
+  Inputs run_inputs;
+  std::uint64_t run_length = 0;
+  std::optional<ReplaySummary> end;
+
+  bool next_chunk();
+
+public:
+  ReplayReader(const std::string&);
+  bool good() const;
+  const HandlingSettings& handling_settings() const;
+  const Playfield& starting_playfield() const;
+  // Inputs of the next frame, nothing once the recording is over
+  std::optional<Inputs> next();
+  // Only known after next() ran out, missing if the file was cut short
+  const std::optional<ReplaySummary>& summary() const;
+};
+
+enum class ReplayResult {
+  Verified,
+  Mismatch,
+  Truncated,
+  Invalid,
+};
+
+// Plays a replay back as fast as possible and checks the final state
+ReplayResult verify_replay(const std::string&, ReplaySummary* = nullptr);
+
+#endif
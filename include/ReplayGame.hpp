@@ -0,0 +1,29 @@
+#ifndef REPLAY_GAME_H
+#define REPLAY_GAME_H
+
+#include "KeyboardController.hpp"
+#include "PlayfieldRenderer.hpp"
+#include "Replay.hpp"
+
+// Plays a recorded session back a frame per tick, holding Right fast forwards
+class ReplayGame {
+  static constexpr int FAST_FORWARD_FRAMES = 8;
+
+  const DrawingDetails drawing_details;
+  const PlayfieldRenderer renderer;
+  ReplayReader reader;
+  Playfield playfield;
+  bool paused = false;
+  bool finished = false;
+  bool fast_forward = false;
+
+  void step();
+
+public:
+  ReplayGame(const std::string&);
+  void update(std::span<const KeyEvent>);
+  void draw() const;
+  bool should_stop_running() const;
+};
+
+#endif
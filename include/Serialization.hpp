@@ -0,0 +1,83 @@
+#ifndef SERIALIZATION_HPP
+#define SERIALIZATION_HPP
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <span>
+#include <vector>
+
+// Bits are packed least significant first, so the byte stream is the same on
+// every platform regardless of endianness, padding or struct layout.
+class BitWriter {
+  std::vector<std::uint8_t> bytes;
+  std::size_t bit_count = 0;
+
+public:
+  void write(std::uint64_t value, unsigned int bits);
+  void write_bool(bool value);
+  void write_signed(std::int64_t value, unsigned int bits);
+  // 7 bits per group plus a continuation bit, small values stay small
+  void write_varint(std::uint64_t value);
+  std::span<const std::uint8_t> data() const;
+  // Starts over, keeping the bytes allocated so far
+  void clear();
+};
+
+class BitReader {
+  std::span<const std::uint8_t> bytes;
+  std::size_t bit_position = 0;
+  bool failed = false;
+
+public:
+  BitReader(std::span<const std::uint8_t>);
+  std::uint64_t read(unsigned int bits);
+  bool read_bool();
+  std::int64_t read_signed(unsigned int bits);
+  std::uint64_t read_varint();
+  // Reads a value and fails the reader unless it is at most max
+  std::uint64_t read_at_most(unsigned int bits, std::uint64_t max);
+  void fail();
+  bool good() const;
+};
+
+// Save files are a header followed by checksummed records:
+//   header: magic "RTRS", u16 format version
+//   record: u8 kind, u32 payload size, payload, u32 FNV-1a of kind + payload
+// Reading stops at the first record that is truncated or fails its checksum.
+namespace save_file {
+constexpr std::array<char, 4> MAGIC = {'R', 'T', 'R', 'S'};
+// Versions so far: 1 the first layout, 2 added the queue's RNG state, 3 ARR,
+// DCD and SDF in handling settings, 4 garbage in playfield snapshots
+constexpr std::uint16_t VERSION = 4;
+// First version whose handling settings have ARR, DCD and SDF
+constexpr std::uint16_t TUNING_VERSION = 3;
+// First version whose configs all end in a render mode. It was appended
+// partway through version 2, so those configs may or may not have one.
+constexpr std::uint16_t RENDER_MODE_VERSION = 3;
+
+enum class RecordKind : std::uint8_t {
+  Snapshot,
+  Lock,
+  Config,
+  ReplayStart,
+  ReplayInputs,
+  ReplayEnd,
+};
+
+struct Record {
+  RecordKind kind;
+  std::vector<std::uint8_t> payload;
+};
+
+void write_header(std::ostream&);
+// Returns the file's format version, which may be older than VERSION
+std::optional<std::uint16_t> read_header(std::istream&);
+void write_record(std::ostream&, RecordKind, const BitWriter&);
+std::optional<Record> read_record(std::istream&);
+// Reads into record, reusing its payload's storage
+bool read_record(std::istream&, Record&);
+} // namespace save_file
+
+#endif
@@ -1,33 +1,39 @@
 #ifndef SETTINGS_MENU_HPP
 #define SETTINGS_MENU_HPP
 
-#include "HandlingSettings.hpp"
+#include "Config.hpp"
+#include "HudText.hpp"
 #include <utility>
 
-enum class Resolution {
-  Small,
-  Medium,
-  Big,
-  FullScreen
-};
-
 std::pair<int, int> resolution_pair(Resolution resolution);
 
+const char* to_string(RenderMode);
+
 class SettingsMenu {
-  static constexpr int OPTIONS = 3;
+public:
+  using Config = ::Config;
+
+private:
+  static constexpr int OPTIONS = 7;
   int selected_option = 0;
+  // Written back to the shared config when the menu closes
+  Config edited_config;
+  const HudLabel title{"SETTINGS"};
+  mutable HudText<int, int> resolution_text{"{} x {}"};
+  mutable HudText<int> das_text{"{}"};
+  mutable HudText<int> soft_drop_text{"{}"};
+  mutable HudText<int> arr_text{"{}"};
+  mutable HudText<int> dcd_text{"{}"};
+  mutable HudText<int> sdf_text{"{}"};
 
 public:
+  SettingsMenu();
   ~SettingsMenu();
   void draw() const;
   void update();
   bool should_stop_running() const;
 
-  struct Config {
-    Resolution resolution;
-    HandlingSettings handling_settings;
-  };
-  static const Config& config();
+  static Config config();
 };
 
 #endif
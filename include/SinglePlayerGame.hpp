@@ -1,17 +1,20 @@
 #ifndef SINGLE_PLAYER_GAME_H
 #define SINGLE_PLAYER_GAME_H
 
+#include "Autosave.hpp"
 #include "Game.hpp"
-#include <stack>
+#include "UndoHistory.hpp"
 
 class SinglePlayerGame {
   Game game;
-  std::stack<Playfield> undoMoveStack;
+  UndoHistory history;
+  Autosave autosave;
+
+  void restored();
 
 public:
   SinglePlayerGame(const HandlingSettings&);
-  ~SinglePlayerGame();
-  void update();
+  void update(std::span<const KeyEvent>);
   void draw() const;
   bool should_stop_running() const;
 };
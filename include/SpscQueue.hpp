@@ -0,0 +1,53 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+// Bounded lock-free queue between exactly one producer and one consumer.
+// Each side only writes its own index, so neither ever waits on the other.
+template <typename T, std::size_t CAPACITY>
+class SpscQueue {
+  static_assert(std::has_single_bit(CAPACITY));
+
+  std::array<T, CAPACITY> slots;
+  // Next slot to pop, written by the consumer
+  alignas(64) std::atomic<std::size_t> head{0};
+  // Next slot to push, written by the producer
+  alignas(64) std::atomic<std::size_t> tail{0};
+
+public:
+  // Producer side, drops the value and returns false when full
+  bool push(const T& value) {
+    auto back = tail.load(std::memory_order_relaxed);
+    if (back - head.load(std::memory_order_acquire) == CAPACITY)
+      return false;
+    slots[back % CAPACITY] = value;
+    tail.store(back + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side, the oldest value or nullptr when empty
+  const T* front() const {
+    auto first = head.load(std::memory_order_relaxed);
+    if (first == tail.load(std::memory_order_acquire))
+      return nullptr;
+    return &slots[first % CAPACITY];
+  }
+
+  // Consumer side, only after front() returned a value
+  void pop() {
+    head.store(
+      head.load(std::memory_order_relaxed) + 1, std::memory_order_release
+    );
+  }
+
+  // Consumer side
+  void clear() {
+    head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
+  }
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs independent jobs (games, replays, batch shards) on every core. Each
+// worker starts with an even slice of the index range and, once it runs dry,
+// steals the back half of another worker's slice, so a few long games do not
+// leave the other cores idle.
+class ThreadPool {
+public:
+  using Task = std::function<void(std::size_t index, unsigned worker)>;
+
+private:
+  struct alignas(64) Slice {
+    std::mutex mutex;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+  };
+
+  std::vector<std::thread> threads;
+  std::unique_ptr<Slice[]> slices;
+  std::mutex mutex;
+  std::condition_variable start;
+  std::condition_variable done;
+  const Task* task = nullptr;
+  std::uint64_t generation = 0;
+  unsigned running = 0;
+  bool stopping = false;
+
+  void work(unsigned worker);
+  bool pop(unsigned worker, std::size_t& index);
+  bool steal(unsigned worker, std::size_t& index);
+
+public:
+  ThreadPool(unsigned threads = std::thread::hardware_concurrency());
+  ~ThreadPool();
+  unsigned size() const;
+  // Calls task(i, worker) for every i below count and waits for all of them.
+  // Tasks on the same worker never overlap, so per-worker state needs no lock.
+  void parallel_for(std::size_t count, const Task& task);
+};
+
+#endif
@@ -2,14 +2,35 @@
 #define TWO_PLAYER_GAME_H
 
 #include "Game.hpp"
+#include "Random.hpp"
 
 class TwoPlayerGame {
   Game game1;
   Game game2;
+  // Empty columns of the garbage each player sends the other
+  Pcg32 holes;
 
 public:
-  TwoPlayerGame(const HandlingSettings&, const HandlingSettings&);
-  void update();
+#if defined(PLATFORM_WEB)
+  // Without threads the search runs inside the frame, so it is kept short
+  static constexpr BotSettings CPU{
+    .beam_width = 8, .depth = 3, .delay_frames = 30
+  };
+#else
+  static constexpr BotSettings CPU{
+    .beam_width = 32,
+    .time_budget = std::chrono::milliseconds(100),
+    .delay_frames = 30,
+  };
+#endif
+
+  // The second player is a bot when cpu is set
+  TwoPlayerGame(
+    const HandlingSettings&,
+    const HandlingSettings&,
+    const std::optional<BotSettings>& cpu = std::nullopt
+  );
+  void update(std::span<const KeyEvent>);
   void draw() const;
   bool should_stop_running() const;
 };
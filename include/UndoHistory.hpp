@@ -0,0 +1,33 @@
+#ifndef UNDO_HISTORY_HPP
+#define UNDO_HISTORY_HPP
+
+#include "Arena.hpp"
+#include "Playfield.hpp"
+
+// Undo/redo journal of locked pieces. Every lock stores a PieceLock, and every
+// KEYFRAME_INTERVAL locks a full Playfield is kept to replay from, so a state
+// is rebuilt with at most KEYFRAME_INTERVAL - 1 replays. Both live in ring
+// buffers sized for MAX_LOCKS up front, so playing never allocates.
+class UndoHistory {
+public:
+  static constexpr std::size_t KEYFRAME_INTERVAL = 32;
+  static constexpr std::size_t MAX_LOCKS = 128 * KEYFRAME_INTERVAL;
+
+private:
+  // keyframes[k] is the state after k * KEYFRAME_INTERVAL locks and locks[i]
+  // leads from state i to state i + 1, both counted from the oldest state kept
+  RingBuffer<Playfield> keyframes;
+  RingBuffer<PieceLock> locks;
+  std::size_t current = 0;
+
+  Playfield state(std::size_t) const;
+
+public:
+  UndoHistory(const Playfield&);
+  void reset(const Playfield&);
+  void push(const Playfield&);
+  bool undo(Playfield&);
+  bool redo(Playfield&);
+};
+
+#endif
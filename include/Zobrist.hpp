@@ -0,0 +1,71 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include "FallingPiece.hpp"
+#include "Grid.hpp"
+#include "NextQueue.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+// Random keys for Zobrist hashing: a state hashes to the XOR of the keys of
+// everything in it, so a change only XORs out the keys of what it removed and
+// XORs in those of what it added. Built at compile time from splitmix64, the
+// same keys on every platform.
+namespace zobrist {
+constexpr std::size_t TETROMINOES = std::to_underlying(Tetromino::Empty) + 1;
+// The falling piece, then the preview
+constexpr std::size_t PIECE_SLOTS = NextQueue::NEXT_SIZE + 1;
+
+constexpr std::uint64_t splitmix64(std::uint64_t& state) {
+  std::uint64_t key = state += 0x9E3779B97F4A7C15;
+  key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9;
+  key = (key ^ (key >> 27)) * 0x94D049BB133111EB;
+  return key ^ (key >> 31);
+}
+
+struct Keys {
+  std::array<std::array<std::uint64_t, Grid::WIDTH>, Grid::HEIGHT> cells;
+  std::array<std::uint64_t, TETROMINOES> hold;
+  std::array<std::array<std::uint64_t, TETROMINOES>, PIECE_SLOTS> pieces;
+  std::uint64_t can_swap;
+  // Counts have no bound, their keys are mixed from these
+  std::uint64_t combo;
+  std::uint64_t b2b;
+};
+
+constexpr Keys make_keys() {
+  std::uint64_t state = 0x5241595452495321;
+  Keys keys{};
+  for (auto& row : keys.cells)
+    for (auto& key : row)
+      key = splitmix64(state);
+  for (auto& key : keys.hold)
+    key = splitmix64(state);
+  for (auto& slot : keys.pieces)
+    for (auto& key : slot)
+      key = splitmix64(state);
+  keys.can_swap = splitmix64(state);
+  keys.combo = splitmix64(state);
+  keys.b2b = splitmix64(state);
+  return keys;
+}
+
+inline constexpr Keys KEYS = make_keys();
+
+// Key of the filled cells of row y
+constexpr std::uint64_t row(std::size_t y, Grid::RowMask mask) {
+  std::uint64_t key = 0;
+  for (; mask != Grid::EMPTY_ROW; mask &= mask - 1)
+    key ^= KEYS.cells[y][std::countr_zero(mask)];
+  return key;
+}
+
+constexpr std::uint64_t count(std::uint64_t salt, unsigned int value) {
+  std::uint64_t state = salt ^ value;
+  return splitmix64(state);
+}
+}; // namespace zobrist
+
+#endif
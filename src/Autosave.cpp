@@ -0,0 +1,74 @@
+#include "Autosave.hpp"
+#include "Serialization.hpp"
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+Autosave::Autosave(std::string _path) : path(std::move(_path)) {}
+
+std::optional<Playfield> Autosave::load(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  // Version 1 queues had no RNG state, start those games over
+  if (!in.good() || save_file::read_header(in) != save_file::VERSION)
+    return std::nullopt;
+
+  auto snapshot = save_file::read_record(in);
+  if (!snapshot || snapshot->kind != save_file::RecordKind::Snapshot)
+    return std::nullopt;
+  Playfield playfield;
+  BitReader snapshot_reader(snapshot->payload);
+  playfield.load(snapshot_reader);
+  if (!snapshot_reader.good())
+    return std::nullopt;
+
+  // A truncated or corrupt tail only loses the locks after the last good one
+  while (auto record = save_file::read_record(in)) {
+    if (record->kind != save_file::RecordKind::Lock)
+      break;
+    PieceLock lock = playfield.last_lock();
+    BitReader lock_reader(record->payload);
+    lock.load(lock_reader);
+    if (!lock_reader.good() || !playfield.can_replay(lock))
+      break;
+    playfield.replay(lock);
+  }
+  return playfield;
+}
+
+void Autosave::snapshot(const Playfield& playfield) {
+  // The new snapshot is written next to the old save and renamed over it, so
+  // quitting or crashing halfway still leaves a save to load
+  const std::string temporary = path + ".tmp";
+  out.close();
+  out.open(temporary, std::ios::binary | std::ios::trunc);
+  save_file::write_header(out);
+  writer.clear();
+  playfield.save(writer);
+  save_file::write_record(out, save_file::RecordKind::Snapshot, writer);
+  out.flush();
+  const bool written = out.good();
+  out.close();
+
+  if (!written)
+    return;
+  // std::filesystem::rename, unlike std::rename, replaces the old save on
+  // Windows too. Left closed on failure, the next lock tries again.
+  std::error_code error;
+  std::filesystem::rename(temporary, path, error);
+  if (error)
+    return;
+  out.open(path, std::ios::binary | std::ios::app);
+  locks = 0;
+}
+
+void Autosave::lock(const Playfield& playfield) {
+  if (!out.is_open() || locks >= MAX_LOCKS) {
+    snapshot(playfield);
+    return;
+  }
+  writer.clear();
+  playfield.last_lock().save(writer);
+  save_file::write_record(out, save_file::RecordKind::Lock, writer);
+  out.flush();
+  locks += 1;
+}
@@ -0,0 +1,155 @@
+#include "BotController.hpp"
+#include <algorithm>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+using Cells = std::array<std::pair<int, int>, 4>;
+
+// Placements are told apart by the cells they fill, orientations of I, S
+// and Z can fill the same ones
+Cells cells(const FallingPiece& piece) {
+  Cells cells;
+  for (std::size_t i = 0; i < cells.size(); i++)
+    cells[i] = {piece.x + piece.map[i].x, piece.y + piece.map[i].y};
+  std::ranges::sort(cells);
+  return cells;
+}
+}; // namespace
+
+BotController::BotController(const BotSettings& _settings) :
+  settings(_settings),
+  search(_settings) {
+  // Plans are a few dozen inputs, more only with a slow soft drop
+  planned.reserve(256);
+  if (settings.time_budget.count() > 0)
+    worker = std::thread(&BotController::run, this);
+}
+
+BotController::~BotController() {
+  if (!worker.joinable())
+    return;
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+  wake.notify_one();
+  worker.join();
+}
+
+void BotController::run() {
+  std::unique_lock lock(mutex);
+  while (true) {
+    wake.wait(lock, [this] { return stopping || request; });
+    if (stopping)
+      return;
+    SearchState state = *request;
+    request.reset();
+    lock.unlock();
+    auto plan = search.search(state, Clock::now() + settings.time_budget);
+    lock.lock();
+    result = plan;
+    has_result = true;
+  }
+}
+
+BotController::Snapshot BotController::snapshot(const Playfield& playfield) {
+  return {
+    playfield.grid.revision(),
+    playfield.falling_piece.tetromino,
+    playfield.holding_piece,
+  };
+}
+
+void BotController::start_search(const Playfield& playfield) {
+  searching = true;
+  searched = snapshot(playfield);
+  if (!worker.joinable()) {
+    auto state = SearchState::of(playfield);
+    result = search.search(state, Clock::time_point::max());
+    has_result = true;
+    return;
+  }
+  {
+    std::lock_guard lock(mutex);
+    request = SearchState::of(playfield);
+  }
+  wake.notify_one();
+}
+
+bool BotController::take_result(std::optional<BotPlan>& plan) {
+  std::unique_lock lock(mutex, std::defer_lock);
+  if (worker.joinable())
+    lock.lock();
+  if (!has_result)
+    return false;
+  has_result = false;
+  plan = result;
+  return true;
+}
+
+// Finds the path to the target from where the piece is now, preferring the
+// planned spin
+Inputs BotController::begin_plan(
+  const Playfield& playfield, const HandlingSettings& handling
+) {
+  const Cells target_cells = cells(target->piece);
+  const MoveGenerator::Placement* path = nullptr;
+  for (const auto& placement :
+       generator.generate(playfield.grid, playfield.falling_piece)) {
+    if (cells(placement.piece) != target_cells)
+      continue;
+    if (!path || placement.spin == target->spin)
+      path = &placement;
+    if (placement.spin == target->spin)
+      break;
+  }
+  target.reset();
+  // Out of reach by now, the next tick searches again
+  if (!path)
+    return {};
+  generator.inputs(*path, handling, planned);
+  planned_revision = playfield.grid.revision();
+  next_input = 1;
+  return planned[0];
+}
+
+Inputs BotController::tick(
+  const Playfield& playfield, const HandlingSettings& handling
+) {
+  // A plan ends with its hard drop, or early when gravity locked the piece
+  if (!planned.empty()) {
+    if (playfield.grid.revision() == planned_revision &&
+        next_input < planned.size())
+      return planned[next_input++];
+    planned.clear();
+    wait_frames = settings.delay_frames;
+  }
+  if (playfield.lost())
+    return {};
+  if (wait_frames > 0) {
+    wait_frames--;
+    return {};
+  }
+
+  if (!target) {
+    if (!searching)
+      start_search(playfield);
+    std::optional<BotPlan> plan;
+    if (!take_result(plan))
+      return {};
+    searching = false;
+    if (!plan || snapshot(playfield) != searched)
+      return {};
+    target = plan;
+  }
+  if (target->swap) {
+    target->swap = false;
+    if (playfield.can_swap) {
+      Inputs inputs;
+      inputs.set(Action::Swap);
+      return inputs;
+    }
+  }
+  return begin_plan(playfield, handling);
+}
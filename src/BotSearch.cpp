@@ -0,0 +1,214 @@
+#include "BotSearch.hpp"
+#include "Zobrist.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// The board's Zobrist hash with what decides the rest of the game
+std::uint64_t node_key(const Grid& grid, Tetromino hold, std::size_t index) {
+  const auto hold_key = zobrist::KEYS.hold[std::to_underlying(hold)];
+  return grid.hash() ^ zobrist::count(hold_key, index);
+}
+
+FallingPiece spawn(Tetromino tetromino) {
+  return FallingPiece(
+    tetromino, Playfield::INITIAL_X_POSITION, Playfield::INITIAL_Y_POSITION
+  );
+}
+
+// Same as Playfield: a piece locked entirely above the visible rows loses
+bool locks_out(const FallingPiece& piece) {
+  return std::ranges::all_of(piece.map, [&](auto coord) {
+    return piece.y + coord.y < int(Playfield::VISIBLE_HEIGHT);
+  });
+}
+}; // namespace
+
+SearchState SearchState::of(const Playfield& playfield) {
+  SearchState state{
+    playfield.grid,
+    playfield.falling_piece,
+    playfield.holding_piece,
+    playfield.can_swap,
+    {},
+    playfield.combo,
+    playfield.b2b,
+  };
+  for (std::size_t i = 0; i < state.next.size(); i++)
+    state.next[i] = playfield.next_queue[i];
+  return state;
+}
+
+BotSearch::TranspositionTable::TranspositionTable(std::size_t size_log2) :
+  entries(std::size_t{1} << size_log2) {}
+
+bool BotSearch::TranspositionTable::insert(
+  std::uint64_t key, std::uint32_t stamp
+) {
+  Entry& entry = entries[key & (entries.size() - 1)];
+  if (entry.stamp == stamp && entry.key == key)
+    return false;
+  entry = {key, stamp};
+  return true;
+}
+
+// Every beam fits, besides the root. The table has room for a few times the
+// boards a beam looks at, so collisions rarely let a duplicate through.
+// Candidates are sized for the worst case, each node of a beam placing two
+// pieces that report the most placements a generator can, so a search never
+// grows them. Only the pages a search writes to get touched.
+BotSearch::BotSearch(const BotSettings& _settings) :
+  settings(_settings),
+  nodes(settings.beam_width * settings.depth + 1),
+  table(16) {
+  candidates.reserve(
+    std::max<std::size_t>(settings.beam_width, 1) * 2 *
+    MoveGenerator::MAX_PLACEMENTS
+  );
+  beam.reserve(settings.beam_width);
+  next_beam.reserve(settings.beam_width);
+}
+
+void BotSearch::add_candidates(
+  std::uint32_t parent,
+  const FallingPiece& piece,
+  bool swap,
+  Tetromino hold,
+  int index
+) {
+  const Node& node = nodes[parent];
+  if (!node.grid.fits(piece))
+    return;
+  for (const auto& placement : generator.generate(node.grid, piece)) {
+    if (locks_out(placement.piece))
+      continue;
+    BoardFeatures features = board_features(node.grid, placement.piece);
+    const int cleared = features.cleared_rows;
+    unsigned int combo = cleared > 0 ? node.combo + 1 : 0;
+    unsigned int b2b = node.b2b;
+    if (cleared > 0)
+      b2b = cleared == 4 || placement.spin != SpinType::No ? b2b + 1 : 0;
+    bool all_clear = cleared > 0 && features.aggregate_height == 0;
+    int reward = node.reward +
+      settings.attack_weight *
+        int(attack_lines(cleared, placement.spin, combo, b2b, all_clear));
+    candidates.push_back({
+      parent,
+      std::uint32_t(candidates.size()),
+      swap,
+      placement.piece,
+      placement.spin,
+      hold,
+      std::uint8_t(index),
+      combo,
+      b2b,
+      reward,
+      reward + evaluate(features, settings.weights),
+    });
+  }
+}
+
+// The piece to play next, or with a swap either the held one or, with an
+// empty hold, the one after it. Only the first piece starts where the
+// falling piece is, the others spawn.
+void BotSearch::expand(
+  std::uint32_t parent, const SearchState& state, const Sequence& sequence
+) {
+  const Node& node = nodes[parent];
+  const int index = node.index;
+  const bool root = parent == 0;
+  if (index >= int(sequence.size()))
+    return;
+  add_candidates(
+    parent,
+    root ? state.falling : spawn(sequence[index]),
+    false,
+    node.hold,
+    index + 1
+  );
+  if (root && !state.can_swap)
+    return;
+  if (node.hold != Tetromino::Empty)
+    add_candidates(parent, spawn(node.hold), true, sequence[index], index + 1);
+  else if (index + 1 < int(sequence.size()))
+    add_candidates(
+      parent, spawn(sequence[index + 1]), true, sequence[index], index + 2
+    );
+}
+
+std::optional<BotPlan> BotSearch::search(
+  const SearchState& state, Clock::time_point deadline
+) {
+  Sequence sequence;
+  sequence[0] = state.falling.tetromino;
+  std::ranges::copy(state.next, sequence.begin() + 1);
+
+  nodes.reset();
+  Node& root = *nodes.allocate();
+  root.grid = state.grid;
+  root.hold = state.hold;
+  root.index = 0;
+  root.combo = state.combo;
+  root.b2b = state.b2b;
+  root.reward = 0;
+  beam.assign(1, 0);
+
+  std::optional<BotPlan> best;
+  for (std::size_t depth = 0; depth < settings.depth; depth++) {
+    candidates.clear();
+    for (auto parent : beam) {
+      // The first depth always finishes, so there is a plan to return
+      if (depth > 0 && Clock::now() >= deadline)
+        return best;
+      expand(parent, state, sequence);
+    }
+    // Ties go to the earlier candidate, so every standard library picks the
+    // same boards
+    std::ranges::sort(candidates, [](const auto& a, const auto& b) {
+      return a.score != b.score ? a.score > b.score : a.order < b.order;
+    });
+
+    stamp++;
+    next_beam.clear();
+    for (const Candidate& candidate : candidates) {
+      if (next_beam.size() == settings.beam_width)
+        break;
+      const Node& parent = nodes[candidate.parent];
+      scratch = parent.grid;
+      scratch.place(candidate.piece);
+      scratch.clear_full_rows(candidate.piece);
+      if (candidate.index < sequence.size() &&
+          !scratch.fits(spawn(sequence[candidate.index])))
+        continue;
+      if (!table.insert(
+            node_key(scratch, candidate.hold, candidate.index), stamp
+          ))
+        continue;
+
+      Node& child = *nodes.allocate();
+      auto child_index = std::uint32_t(nodes.index_of(child));
+      child.grid = scratch;
+      child.hold = candidate.hold;
+      child.index = candidate.index;
+      child.combo = candidate.combo;
+      child.b2b = candidate.b2b;
+      child.reward = candidate.reward;
+      child.score = candidate.score;
+      child.first = depth == 0 ? child_index : parent.first;
+      child.swap = candidate.swap;
+      child.piece = candidate.piece;
+      child.spin = candidate.spin;
+      next_beam.push_back(child_index);
+    }
+    if (next_beam.empty())
+      break;
+
+    const Node& top = nodes[next_beam.front()];
+    const Node& first = nodes[top.first];
+    best = BotPlan{first.swap, first.piece, first.spin, top.score, depth + 1};
+    std::swap(beam, next_beam);
+  }
+  return best;
+}
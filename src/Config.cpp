@@ -0,0 +1,40 @@
+#include "Config.hpp"
+#include "Serialization.hpp"
+#include <istream>
+#include <ostream>
+#include <utility>
+
+void write_config(std::ostream& out, const Config& config) {
+  BitWriter writer;
+  writer.write(std::to_underlying(config.resolution), 2);
+  config.handling_settings.save(writer);
+  writer.write(std::to_underlying(config.render_mode), 2);
+  save_file::write_header(out);
+  save_file::write_record(out, save_file::RecordKind::Config, writer);
+}
+
+std::optional<Config> read_config(std::istream& in) {
+  const auto version = save_file::read_header(in);
+  if (!version)
+    return std::nullopt;
+  auto record = save_file::read_record(in);
+  if (!record || record->kind != save_file::RecordKind::Config)
+    return std::nullopt;
+
+  BitReader reader(record->payload);
+  Config config;
+  auto last_resolution = std::to_underlying(Resolution::FullScreen);
+  config.resolution = static_cast<Resolution>(
+    reader.read_at_most(2, last_resolution)
+  );
+  config.handling_settings.load(reader, *version);
+  if (*version >= save_file::RENDER_MODE_VERSION) {
+    auto last_render_mode = std::to_underlying(RenderMode::TickRate);
+    config.render_mode = static_cast<RenderMode>(
+      reader.read_at_most(2, last_render_mode)
+    );
+  }
+  if (!reader.good())
+    return std::nullopt;
+  return config;
+}
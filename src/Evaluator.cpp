@@ -0,0 +1,306 @@
+#include "Evaluator.hpp"
+#include "PieceTables.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdlib>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace {
+constexpr std::uint16_t FULL = Grid::FULL_ROW;
+// Rows padded with a wall column on each side, cell x moves to bit x + 1
+constexpr std::uint16_t WALLS = 1 | 1u << (Grid::WIDTH + 1);
+constexpr std::uint16_t PADDED_FULL = (1u << (Grid::WIDTH + 2)) - 1;
+constexpr std::uint16_t INSIDE = FULL << 1;
+
+// The grid's rows and floor rows below them, up to a multiple of the widest
+// vector. Floor rows are full, so they add no holes, transitions or slots.
+constexpr std::size_t ROWS = 48;
+// An empty row above the grid, then the rows looked at, then slack for the
+// row below the last one. Row y is at index y + 1.
+using Buffer = std::array<std::uint16_t, 64>;
+
+// The same few operations on one row, 8 rows or 16 rows at a time. Shifts
+// are per lane, scan_or leaves every lane with the OR of itself, the lanes
+// before it and carry, then carries the last lane on to the next vector.
+struct Scalar {
+  using V = std::uint16_t;
+  static constexpr std::size_t LANES = 1;
+
+  static V load(const std::uint16_t* p) { return *p; }
+  static void store(std::uint16_t* p, V v) { *p = v; }
+  static V set(std::uint16_t v) { return v; }
+  static V bit_or(V a, V b) { return a | b; }
+  static V bit_and(V a, V b) { return a & b; }
+  static V bit_xor(V a, V b) { return a ^ b; }
+  // ~a & b
+  static V and_not(V a, V b) { return ~a & b; }
+  static V add(V a, V b) { return a + b; }
+  static V sub(V a, V b) { return a - b; }
+  static V equal(V a, V b) { return a == b ? 0xFFFF : 0; }
+  template <int N> static V left(V a) { return a << N; }
+  template <int N> static V right(V a) { return a >> N; }
+  static V scan_or(V a, V& carry) { return carry |= a; }
+  static unsigned int sum(V a) { return a; }
+};
+
+#if defined(__AVX2__)
+struct Avx2 {
+  using V = __m256i;
+  static constexpr std::size_t LANES = 16;
+
+  static V load(const std::uint16_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const V*>(p));
+  }
+  static void store(std::uint16_t* p, V v) {
+    _mm256_storeu_si256(reinterpret_cast<V*>(p), v);
+  }
+  static V set(std::uint16_t v) { return _mm256_set1_epi16(short(v)); }
+  static V bit_or(V a, V b) { return _mm256_or_si256(a, b); }
+  static V bit_and(V a, V b) { return _mm256_and_si256(a, b); }
+  static V bit_xor(V a, V b) { return _mm256_xor_si256(a, b); }
+  static V and_not(V a, V b) { return _mm256_andnot_si256(a, b); }
+  static V add(V a, V b) { return _mm256_add_epi16(a, b); }
+  static V sub(V a, V b) { return _mm256_sub_epi16(a, b); }
+  static V equal(V a, V b) { return _mm256_cmpeq_epi16(a, b); }
+  template <int N> static V left(V a) { return _mm256_slli_epi16(a, N); }
+  template <int N> static V right(V a) { return _mm256_srli_epi16(a, N); }
+
+  // Byte shifts stay within each 128 bit half, the low half's last lane is
+  // carried into the high half separately
+  static V scan_or(V a, V& carry) {
+    a = _mm256_or_si256(a, _mm256_slli_si256(a, 2));
+    a = _mm256_or_si256(a, _mm256_slli_si256(a, 4));
+    a = _mm256_or_si256(a, _mm256_slli_si256(a, 8));
+    a = _mm256_or_si256(a, _mm256_permute2x128_si256(last(a), a, 0x08));
+    a = _mm256_or_si256(a, carry);
+    carry = _mm256_permute2x128_si256(last(a), a, 0x11);
+    return a;
+  }
+  // Each half filled with its own last lane
+  static V last(V a) {
+    a = _mm256_shufflehi_epi16(a, 0xFF);
+    return _mm256_unpackhi_epi64(a, a);
+  }
+  static unsigned int sum(V a) {
+    alignas(32) std::array<std::uint16_t, LANES> lanes;
+    store(lanes.data(), a);
+    unsigned int total = 0;
+    for (auto lane : lanes)
+      total += lane;
+    return total;
+  }
+};
+using Vector = Avx2;
+#elif defined(__SSE2__) || defined(_M_X64)
+struct Sse2 {
+  using V = __m128i;
+  static constexpr std::size_t LANES = 8;
+
+  static V load(const std::uint16_t* p) {
+    return _mm_loadu_si128(reinterpret_cast<const V*>(p));
+  }
+  static void store(std::uint16_t* p, V v) {
+    _mm_storeu_si128(reinterpret_cast<V*>(p), v);
+  }
+  static V set(std::uint16_t v) { return _mm_set1_epi16(short(v)); }
+  static V bit_or(V a, V b) { return _mm_or_si128(a, b); }
+  static V bit_and(V a, V b) { return _mm_and_si128(a, b); }
+  static V bit_xor(V a, V b) { return _mm_xor_si128(a, b); }
+  static V and_not(V a, V b) { return _mm_andnot_si128(a, b); }
+  static V add(V a, V b) { return _mm_add_epi16(a, b); }
+  static V sub(V a, V b) { return _mm_sub_epi16(a, b); }
+  static V equal(V a, V b) { return _mm_cmpeq_epi16(a, b); }
+  template <int N> static V left(V a) { return _mm_slli_epi16(a, N); }
+  template <int N> static V right(V a) { return _mm_srli_epi16(a, N); }
+
+  static V scan_or(V a, V& carry) {
+    a = _mm_or_si128(a, _mm_slli_si128(a, 2));
+    a = _mm_or_si128(a, _mm_slli_si128(a, 4));
+    a = _mm_or_si128(a, _mm_slli_si128(a, 8));
+    a = _mm_or_si128(a, carry);
+    carry = _mm_shufflehi_epi16(a, 0xFF);
+    carry = _mm_unpackhi_epi64(carry, carry);
+    return a;
+  }
+  static unsigned int sum(V a) {
+    alignas(16) std::array<std::uint16_t, LANES> lanes;
+    store(lanes.data(), a);
+    unsigned int total = 0;
+    for (auto lane : lanes)
+      total += lane;
+    return total;
+  }
+};
+using Vector = Sse2;
+#else
+using Vector = Scalar;
+#endif
+
+// Lanes hold at most 12 bits, so the counts never carry between bytes
+template <class I> typename I::V popcount(typename I::V a) {
+  a = I::sub(a, I::bit_and(I::template right<1>(a), I::set(0x5555)));
+  a = I::add(
+    I::bit_and(a, I::set(0x3333)),
+    I::bit_and(I::template right<2>(a), I::set(0x3333))
+  );
+  a = I::bit_and(I::add(a, I::template right<4>(a)), I::set(0x0F0F));
+  return I::bit_and(I::add(a, I::template right<8>(a)), I::set(0x1F));
+}
+
+// Cells whose both neighbours in the padded row are filled, and itself not
+template <class I> typename I::V between_filled(typename I::V padded) {
+  return I::bit_and(
+    I::and_not(padded, I::template left<1>(padded)),
+    I::template right<1>(padded)
+  );
+}
+
+template <class I> BoardFeatures extract(const Buffer& buffer) {
+  using V = typename I::V;
+  const V zero = I::set(0);
+  const V full = I::set(FULL);
+  const V walls = I::set(WALLS);
+
+  V covered = zero;
+  V holes = zero;
+  V transitions = zero;
+  V slots = zero;
+  V ready = zero;
+  // Columns whose highest filled cell is in the row
+  std::array<std::uint16_t, ROWS> tops;
+  for (std::size_t y = 0; y < ROWS; y += I::LANES) {
+    V above = I::load(&buffer[y]);
+    V row = I::load(&buffer[y + 1]);
+    V below = I::load(&buffer[y + 2]);
+
+    // Every row above, the row before each lane is the lane's above row
+    V cover = I::scan_or(above, covered);
+    V hole_cells = I::bit_and(cover, I::and_not(row, full));
+    holes = I::add(holes, popcount<I>(hole_cells));
+    I::store(&tops[y], I::and_not(cover, row));
+
+    V padded = I::bit_or(I::template left<1>(row), walls);
+    V changes = I::bit_xor(padded, I::template right<1>(padded));
+    changes = I::bit_and(changes, I::set(PADDED_FULL >> 1));
+    transitions = I::add(
+      transitions, I::and_not(I::equal(row, zero), popcount<I>(changes))
+    );
+
+    // Centers of a T pointing down into the row below
+    V empty = I::bit_xor(padded, I::set(PADDED_FULL));
+    V three_wide = I::bit_and(
+      I::bit_and(empty, I::template left<1>(empty)),
+      I::template right<1>(empty)
+    );
+    V padded_below = I::bit_or(I::template left<1>(below), walls);
+    V padded_above = I::bit_or(I::template left<1>(above), walls);
+    V overhang = I::and_not(
+      padded_above,
+      I::bit_or(
+        I::template left<1>(padded_above), I::template right<1>(padded_above)
+      )
+    );
+    V slot = I::bit_and(
+      I::bit_and(three_wide, between_filled<I>(padded_below)),
+      I::bit_and(overhang, I::set(INSIDE))
+    );
+    slots = I::add(slots, popcount<I>(slot));
+
+    V one_missing = I::equal(popcount<I>(row), I::set(Grid::WIDTH - 1));
+    V reachable = I::equal(hole_cells, zero);
+    ready = I::add(
+      ready, I::bit_and(I::bit_and(one_missing, reachable), I::set(1))
+    );
+  }
+
+  BoardFeatures features{};
+  features.holes = I::sum(holes);
+  features.row_transitions = I::sum(transitions);
+  features.t_slots = I::sum(slots);
+  features.ready_rows = I::sum(ready);
+
+  // The first floor row is full, every column has its top by then
+  for (std::size_t y = 0; y <= Grid::HEIGHT; y++)
+    for (unsigned int bits = tops[y]; bits != 0; bits &= bits - 1)
+      features.heights[std::countr_zero(bits)] = Grid::HEIGHT - y;
+
+  const auto& heights = features.heights;
+  for (std::size_t x = 0; x < Grid::WIDTH; x++) {
+    int height = heights[x];
+    features.aggregate_height += height;
+    features.max_height = std::max(features.max_height, height);
+    int left = x > 0 ? heights[x - 1] : Grid::HEIGHT;
+    int right = x + 1 < Grid::WIDTH ? heights[x + 1] : Grid::HEIGHT;
+    features.wells += std::max(std::min(left, right) - height, 0);
+    if (x + 1 < Grid::WIDTH)
+      features.bumpiness += std::abs(height - right);
+  }
+  return features;
+}
+
+Buffer make_buffer(BoardRows rows) {
+  Buffer buffer;
+  buffer.fill(FULL);
+  buffer[0] = 0;
+  std::ranges::copy(rows, buffer.begin() + 1);
+  return buffer;
+}
+}; // namespace
+
+#if defined(__AVX2__)
+const char* const BOARD_FEATURES_ISA = "AVX2";
+#elif defined(__SSE2__) || defined(_M_X64)
+const char* const BOARD_FEATURES_ISA = "SSE2";
+#else
+const char* const BOARD_FEATURES_ISA = "scalar";
+#endif
+
+BoardFeatures board_features(BoardRows rows) {
+  return extract<Vector>(make_buffer(rows));
+}
+
+BoardFeatures board_features(const Grid& grid) {
+  return board_features(grid.row_masks());
+}
+
+// Only rows the piece covers can be full, each is dropped by moving the rows
+// above it down one
+BoardFeatures board_features(const Grid& grid, const FallingPiece& piece) {
+  Buffer buffer = make_buffer(grid.row_masks());
+  const auto& mask = piece_tables::mask(piece.tetromino, piece.orientation);
+  const int top = piece.y + mask.top + 1;
+  const int shift = piece.x - piece_tables::MASK_ORIGIN;
+  int cleared = 0;
+  for (int i = 0; i < mask.height; i++) {
+    const auto row = buffer.begin() + top + i;
+    *row |= shift >= 0 ? mask.rows[i] << shift : mask.rows[i] >> -shift;
+    if (*row == FULL) {
+      std::copy_backward(buffer.begin() + 1, row, row + 1);
+      buffer[1] = 0;
+      cleared++;
+    }
+  }
+  BoardFeatures features = extract<Vector>(buffer);
+  features.cleared_rows = cleared;
+  return features;
+}
+
+BoardFeatures scalar_board_features(BoardRows rows) {
+  return extract<Scalar>(make_buffer(rows));
+}
+
+int evaluate(const BoardFeatures& features, const EvaluationWeights& weights) {
+  return weights.aggregate_height * features.aggregate_height +
+    weights.max_height * features.max_height + weights.holes * features.holes +
+    weights.bumpiness * features.bumpiness + weights.wells * features.wells +
+    weights.row_transitions * features.row_transitions +
+    weights.t_slots * features.t_slots +
+    weights.ready_rows * features.ready_rows +
+    weights.cleared_rows * features.cleared_rows;
+}
@@ -1,4 +1,6 @@
 #include "FallingPiece.hpp"
+#include "PieceTables.hpp"
+#include "Serialization.hpp"
 #include <utility>
 
 FallingPiece::FallingPiece(
@@ -11,24 +13,7 @@ FallingPiece::FallingPiece(
   map(initial_tetromino_map(tetromino)) {}
 
 TetrominoMap initial_tetromino_map(Tetromino tetromino) {
-  switch (tetromino) {
-  case Tetromino::I:
-    return (TetrominoMap){{{-1, 0}, {0, 0}, {1, 0}, {2, 0}}};
-  case Tetromino::O:
-    return (TetrominoMap){{{0, -1}, {1, -1}, {0, 0}, {1, 0}}};
-  case Tetromino::T:
-    return (TetrominoMap){{{0, -1}, {-1, 0}, {0, 0}, {1, 0}}};
-  case Tetromino::S:
-    return (TetrominoMap){{{0, -1}, {1, -1}, {-1, 0}, {0, 0}}};
-  case Tetromino::Z:
-    return (TetrominoMap){{{-1, -1}, {0, -1}, {0, 0}, {1, 0}}};
-  case Tetromino::J:
-    return (TetrominoMap){{{-1, -1}, {-1, 0}, {0, 0}, {1, 0}}};
-  case Tetromino::L:
-    return (TetrominoMap){{{1, -1}, {-1, 0}, {0, 0}, {1, 0}}};
-  default:
-    return (TetrominoMap){{{0, 0}, {0, 0}, {0, 0}, {0, 0}}};
-  }
+  return piece_tables::SPAWN_MAPS[std::to_underlying(tetromino)];
 }
 
 void FallingPiece::fall() {
@@ -43,23 +28,10 @@ void FallingPiece::shift(Shift shift) {
 }
 
 void FallingPiece::rotate(RotationType rotationType) {
-  for (CoordinatePair& pcp : map)
-    if (rotationType == RotationType::Clockwise)
-      pcp = {static_cast<signed char>(-pcp.y), pcp.x};
-    else if (rotationType == RotationType::CounterClockwise)
-      pcp = {pcp.y, static_cast<signed char>(-pcp.x)};
-    else if (rotationType == RotationType::OneEighty)
-      pcp = {
-        static_cast<signed char>(-pcp.x), static_cast<signed char>(-pcp.y)
-      };
-
-  int rotationSteps = (rotationType == RotationType::Clockwise) ? 1 :
-    (rotationType == RotationType::CounterClockwise)            ? 3 :
-    (rotationType == RotationType::OneEighty)                   ? 2 :
-                                                                  0;
-  orientation = static_cast<Orientation>(
-    (std::to_underlying(orientation) + rotationSteps) % 4
-  );
+  const auto& rotation =
+    piece_tables::rotation(tetromino, orientation, rotationType);
+  orientation = rotation.orientation;
+  map = rotation.map;
 }
 
 void FallingPiece::translate(CoordinatePair translation) {
@@ -91,28 +63,20 @@ FallingPiece FallingPiece::translated(CoordinatePair translation) const {
   return new_piece;
 }
 
-const OffsetTable& offset_table(const FallingPiece& piece) {
-  static constexpr OffsetTable I_TABLE[4] = {
-    {{{0, 0}, {-1, 0}, {2, 0}, {-1, 0}, {2, 0}}},
-    {{{-1, 0}, {0, 0}, {0, 0}, {0, -1}, {0, 2}}},
-    {{{-1, -1}, {1, -1}, {-2, -1}, {1, 0}, {-2, 0}}},
-    {{{0, -1}, {0, -1}, {0, -1}, {0, 1}, {0, -2}}},
-  };
-  static constexpr OffsetTable O_TABLE[4] = {
-    {{{0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}}},
-    {{{0, 1}, {0, 1}, {0, 1}, {0, 1}, {0, 1}}},
-    {{{-1, 1}, {-1, 1}, {-1, 1}, {-1, 1}, {-1, 1}}},
-    {{{-1, 0}, {-1, 0}, {-1, 0}, {-1, 0}, {-1, 0}}},
-  };
-  static constexpr OffsetTable DEFAULT_TABLE[4]{
-    {{{0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}}},
-    {{{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}}},
-    {{{0, 0}, {0, 0}, {0, 0}, {0, 0}, {0, 0}}},
-    {{{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}}},
-  };
+void FallingPiece::save(BitWriter& writer) const {
+  writer.write(std::to_underlying(tetromino), 3);
+  writer.write(std::to_underlying(orientation), 2);
+  writer.write_signed(x, 8);
+  writer.write_signed(y, 8);
+}
 
-  const auto& offset_table = piece.tetromino == Tetromino::I ? I_TABLE :
-    piece.tetromino == Tetromino::O                          ? O_TABLE :
-                                                               DEFAULT_TABLE;
-  return offset_table[std::to_underlying(piece.orientation)];
+void FallingPiece::load(BitReader& reader) {
+  auto last_tetromino = std::to_underlying(Tetromino::Empty) - 1;
+  auto new_tetromino = reader.read_at_most(3, last_tetromino);
+  auto new_orientation = reader.read(2);
+  char new_x = reader.read_signed(8);
+  char new_y = reader.read_signed(8);
+  *this = FallingPiece(static_cast<Tetromino>(new_tetromino), new_x, new_y);
+  orientation = static_cast<Orientation>(new_orientation);
+  map = piece_tables::map(tetromino, orientation);
 }
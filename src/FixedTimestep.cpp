@@ -0,0 +1,20 @@
+#include "FixedTimestep.hpp"
+#include <algorithm>
+
+static_assert(FixedTimestep::TICK_RATE > 0, "RAYTRIS_TICK_RATE must be > 0");
+
+FixedTimestep::FixedTimestep(Clock::time_point now) : last(now) {}
+
+int FixedTimestep::advance(Clock::time_point now) {
+  accumulated += now - last;
+  last = now;
+  accumulated = std::min(accumulated, TICK * MAX_TICKS_PER_FRAME);
+
+  int ticks = accumulated / TICK;
+  accumulated -= TICK * ticks;
+  return ticks;
+}
+
+FixedTimestep::Clock::time_point FixedTimestep::next_tick() const {
+  return last + (TICK - accumulated);
+}
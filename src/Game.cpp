@@ -3,15 +3,26 @@
 
 Game::Game(
   const DrawingDetails& _drawing_details,
-  const Controller& _controller,
+  const KeyboardController::Bindings& bindings,
   const HandlingSettings& _settings
 ) :
   drawing_details(_drawing_details),
-  controller(_controller),
+  renderer(_drawing_details),
+  controller(bindings),
   settings(_settings) {}
 
+Game::~Game() {
+  if (recorder)
+    recorder->finish(playfield);
+}
+
+void Game::record(const std::string& path) {
+  recorder.emplace(path, settings);
+  recorder->begin(playfield);
+}
+
 void Game::draw() const {
-  playfield.draw(drawing_details);
+  renderer.draw(playfield);
 
   // Pause Menu
   if (!playfield.lost() && !paused)
@@ -23,8 +34,8 @@ void Game::draw() const {
 
   if (playfield.lost()) {
     DrawText(
-      "YOU LOST",
-      (width - MeasureText("YOU LOST", drawing_details.font_size_big)) / 2.0,
+      lost_label.c_str(),
+      (width - lost_label.width(drawing_details.font_size_big)) / 2.0,
       height / 2.0,
       drawing_details.font_size_big,
       drawing_details.YOU_LOST_COLOR
@@ -32,30 +43,50 @@ void Game::draw() const {
 
   } else if (paused) {
     DrawText(
-      "GAME PAUSED",
-      (width - MeasureText("GAME PAUSED", drawing_details.font_size_big)) / 2.0,
+      paused_label.c_str(),
+      (width - paused_label.width(drawing_details.font_size_big)) / 2.0,
       height / 2.0,
       drawing_details.font_size_big,
       drawing_details.GAME_PAUSED_COLOR
     );
   }
   DrawText(
-    "Press Esc to quit",
-    (width - MeasureText("Press Enter to quit", drawing_details.font_size)) /
-      2.0,
+    quit_label.c_str(),
+    (width - quit_label.width(drawing_details.font_size)) / 2.0,
     height / 2.0 + drawing_details.font_size_big,
     drawing_details.font_size,
     drawing_details.QUIT_COLOR
   );
 }
 
+void Game::play_bot(const BotSettings& bot_settings) {
+  bot.emplace(bot_settings);
+}
+
+// A paused bot would lose the moves it planned, it waits instead
+void Game::poll(std::span<const KeyEvent> events) {
+  if (!bot)
+    inputs = controller.tick(events);
+  else if (!paused)
+    inputs = bot->tick(playfield, settings);
+  else
+    inputs = {};
+}
+
 bool Game::update() {
-  if (controller.restart())
+  if (inputs[Action::Restart]) {
     playfield.restart();
+    renderer.redraw_stack();
+    if (recorder)
+      recorder->begin(playfield);
+  }
 
-  if (controller.pause())
+  if (inputs[Action::Pause])
     paused = !paused;
   if (paused)
     return false;
-  return playfield.update(controller, settings);
+  bool locked = playfield.update(inputs, settings);
+  if (recorder)
+    recorder->record(inputs, locked);
+  return locked;
 }
@@ -0,0 +1,117 @@
+#include "GameBatch.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace sr = std::ranges;
+
+GameBatch::GameBatch(
+  std::size_t size, std::uint64_t seed, const HandlingSettings& _settings
+) :
+  settings(_settings),
+  grid_rows(size * GRID_ROWS),
+  queue_pieces(size * QUEUE_SIZE),
+  hold_pieces(size),
+  piece_poses(size),
+  step_rewards(size),
+  step_done(size) {
+  playfields.reserve(size);
+  for (std::size_t game = 0; game < size; game++) {
+    playfields.emplace_back(seed + game);
+    observe(game);
+  }
+}
+
+std::size_t GameBatch::size() const {
+  return playfields.size();
+}
+
+void GameBatch::observe(std::size_t game) {
+  const Playfield& playfield = playfields[game];
+  observe_piece(game);
+  for (std::size_t y = 0; y < GRID_ROWS; y++)
+    grid_rows[game * GRID_ROWS + y] = playfield.grid.row_mask(y);
+  for (std::size_t i = 0; i < QUEUE_SIZE; i++)
+    queue_pieces[game * QUEUE_SIZE + i] = playfield.next_queue[i];
+  hold_pieces[game] = playfield.holding_piece;
+}
+
+void GameBatch::observe_piece(std::size_t game) {
+  const FallingPiece& piece = playfields[game].falling_piece;
+  piece_poses[game] = {
+    piece.tetromino,
+    piece.orientation,
+    static_cast<signed char>(piece.x),
+    static_cast<signed char>(piece.y)
+  };
+}
+
+void GameBatch::step_game(std::size_t game, Inputs action) {
+  Playfield& playfield = playfields[game];
+  auto score = playfield.score;
+  bool locked = playfield.update(action, settings);
+  step_rewards[game] = playfield.score - score;
+  step_done[game] = playfield.lost();
+  if (step_done[game])
+    playfield.restart();
+  // The grid and queue only change on locks and swaps
+  if (locked || step_done[game] || action[Action::Swap])
+    observe(game);
+  else
+    observe_piece(game);
+}
+
+void GameBatch::step(std::span<const Inputs> actions) {
+  assert(actions.size() == size());
+  for (std::size_t game = 0; game < size(); game++)
+    step_game(game, actions[game]);
+}
+
+void GameBatch::step(std::span<const Inputs> actions, ThreadPool& pool) {
+  assert(actions.size() == size());
+  // Whole shards per task, a task per game would cost more than the step
+  const std::size_t shards = std::min<std::size_t>(size(), pool.size() * 4);
+  pool.parallel_for(shards, [&](std::size_t shard, unsigned) {
+    std::size_t first = size() * shard / shards;
+    std::size_t last = size() * (shard + 1) / shards;
+    for (std::size_t game = first; game < last; game++)
+      step_game(game, actions[game]);
+  });
+}
+
+void GameBatch::reset() {
+  for (std::size_t game = 0; game < size(); game++) {
+    Playfield& playfield = playfields[game];
+    playfield = Playfield(playfield.next_queue.next_seed());
+    observe(game);
+  }
+  sr::fill(step_rewards, 0);
+  sr::fill(step_done, 0);
+}
+
+const Playfield& GameBatch::operator[](std::size_t game) const {
+  return playfields[game];
+}
+
+std::span<const Grid::RowMask> GameBatch::grids() const {
+  return grid_rows;
+}
+
+std::span<const Tetromino> GameBatch::queues() const {
+  return queue_pieces;
+}
+
+std::span<const Tetromino> GameBatch::holds() const {
+  return hold_pieces;
+}
+
+std::span<const GameBatch::PiecePose> GameBatch::pieces() const {
+  return piece_poses;
+}
+
+std::span<const std::uint32_t> GameBatch::rewards() const {
+  return step_rewards;
+}
+
+std::span<const std::uint8_t> GameBatch::done() const {
+  return step_done;
+}
@@ -0,0 +1,80 @@
+#include "Garbage.hpp"
+#include "Grid.hpp"
+#include "Serialization.hpp"
+#include <algorithm>
+
+bool GarbageQueue::empty() const {
+  return count == 0;
+}
+
+unsigned int GarbageQueue::lines() const {
+  return total;
+}
+
+void GarbageQueue::push(GarbageAttack attack) {
+  if (attack.lines == 0)
+    return;
+  if (count == CAPACITY) {
+    GarbageAttack& newest = attacks[(first + count - 1) % CAPACITY];
+    auto merged = std::min<unsigned int>(
+      newest.lines + attack.lines, Grid::HEIGHT
+    );
+    total += merged - newest.lines;
+    newest.lines = merged;
+    return;
+  }
+  attacks[(first + count) % CAPACITY] = attack;
+  count++;
+  total += attack.lines;
+}
+
+unsigned int GarbageQueue::cancel(unsigned int lines) {
+  while (lines > 0 && count > 0) {
+    GarbageAttack& oldest = attacks[first];
+    unsigned int cancelled = std::min<unsigned int>(lines, oldest.lines);
+    oldest.lines -= cancelled;
+    total -= cancelled;
+    lines -= cancelled;
+    if (oldest.lines == 0) {
+      first = (first + 1) % CAPACITY;
+      count--;
+    }
+  }
+  return lines;
+}
+
+GarbageAttack GarbageQueue::pop(unsigned int max_lines) {
+  if (count == 0 || max_lines == 0)
+    return {0, 0};
+  GarbageAttack& oldest = attacks[first];
+  GarbageAttack taken{
+    std::uint8_t(std::min<unsigned int>(max_lines, oldest.lines)), oldest.hole
+  };
+  oldest.lines -= taken.lines;
+  total -= taken.lines;
+  if (oldest.lines == 0) {
+    first = (first + 1) % CAPACITY;
+    count--;
+  }
+  return taken;
+}
+
+void GarbageQueue::save(BitWriter& writer) const {
+  writer.write(count, 5);
+  for (std::size_t i = 0; i < count; i++) {
+    const GarbageAttack& attack = attacks[(first + i) % CAPACITY];
+    writer.write(attack.lines, 6);
+    writer.write(attack.hole, 4);
+  }
+}
+
+void GarbageQueue::load(BitReader& reader) {
+  first = 0;
+  count = reader.read_at_most(5, CAPACITY);
+  total = 0;
+  for (std::size_t i = 0; i < count; i++) {
+    attacks[i].lines = reader.read_at_most(6, Grid::HEIGHT);
+    attacks[i].hole = reader.read_at_most(4, Grid::WIDTH - 1);
+    total += attacks[i].lines;
+  }
+}
@@ -0,0 +1,237 @@
+#include "Grid.hpp"
+#include "PieceTables.hpp"
+#include "Serialization.hpp"
+#include "Zobrist.hpp"
+#include <algorithm>
+#include <bit>
+#include <ranges>
+#include <utility>
+
+namespace sr = std::ranges;
+namespace sv = std::views;
+
+namespace {
+using piece_tables::MASK_ORIGIN;
+using piece_tables::PieceMask;
+
+const PieceMask& piece_mask(const FallingPiece& piece) {
+  return piece_tables::mask(piece.tetromino, piece.orientation);
+}
+
+Grid::RowMask shifted(Grid::RowMask mask, int shift) {
+  return shift >= 0 ? mask << shift : mask >> -shift;
+}
+}; // namespace
+
+Grid::Grid() : rows{} {
+  sr::for_each(cells, [](auto& row) { row.fill(Tetromino::Empty); });
+  columns.fill(FLOOR);
+}
+
+Tetromino Grid::at(int x, int y) const {
+  return cells[y][x];
+}
+
+bool Grid::occupied(int x, int y) const {
+  if (x < 0 || x >= int(WIDTH) || y < 0 || y >= int(HEIGHT))
+    return true;
+  return rows[y] & (1u << x);
+}
+
+Grid::RowMask Grid::row_mask(std::size_t y) const {
+  return rows[y];
+}
+
+std::span<const Grid::RowMask, Grid::HEIGHT> Grid::row_masks() const {
+  return rows;
+}
+
+Grid::ColumnMask Grid::column_mask(std::size_t x) const {
+  return columns[x];
+}
+
+std::uint32_t Grid::revision() const {
+  return changes;
+}
+
+std::uint64_t Grid::hash() const {
+  return zobrist;
+}
+
+void Grid::rehash() {
+  zobrist = 0;
+  for (std::size_t y = stack_top; y < HEIGHT; y++)
+    zobrist ^= zobrist::row(y, rows[y]);
+}
+
+bool Grid::fits(const FallingPiece& piece) const {
+  const PieceMask& mask = piece_mask(piece);
+  int top = piece.y + mask.top;
+  if (piece.x + mask.left < 0 || piece.x + mask.right >= int(WIDTH) ||
+      top < 0 || top + mask.height > int(HEIGHT))
+    return false;
+
+  int shift = piece.x - MASK_ORIGIN;
+  for (int i = 0; i < mask.height; i++)
+    if (rows[top + i] & shifted(mask.rows[i], shift))
+      return false;
+  return true;
+}
+
+// The first filled cell below each mino, floor included, is where the piece
+// stops. Checking every mino rather than the lowest one per column keeps this
+// exact for a piece overlapping the stack, same as stepping it down would be.
+int Grid::drop_distance(const FallingPiece& piece) const {
+  int distance = HEIGHT;
+  for (auto coord : piece.map) {
+    auto below = columns[piece.x + coord.x] >> (piece.y + coord.y + 1);
+    distance = std::min(distance, std::countr_zero(below));
+  }
+  return distance;
+}
+
+int Grid::shift_distance(const FallingPiece& piece, Shift shift) const {
+  int distance = WIDTH;
+  for (auto coord : piece.map) {
+    int x = piece.x + coord.x;
+    // With the walls set just outside the row, the nearest set bit on the
+    // shifting side is what the mino runs into
+    std::uint32_t row = rows[piece.y + coord.y];
+    if (shift == Shift::Left) {
+      auto left = (row << 1 | 1) & ((2u << x) - 1);
+      distance = std::min(distance, x + 1 - int(std::bit_width(left)));
+    } else {
+      auto right = (row | ~std::uint32_t{FULL_ROW}) >> (x + 1);
+      distance = std::min(distance, std::countr_zero(right));
+    }
+  }
+  return distance;
+}
+
+void Grid::place(const FallingPiece& piece) {
+  for (auto coord : piece.map) {
+    int x = coord.x + piece.x;
+    int y = coord.y + piece.y;
+    cells[y][x] = piece.tetromino;
+    stack_top = std::min<std::size_t>(stack_top, y);
+    // Only newly filled cells change the hash, overlapping ones stay in it
+    if (!(rows[y] & (1u << x)))
+      zobrist ^= zobrist::KEYS.cells[y][x];
+    rows[y] |= 1u << x;
+    columns[x] |= ColumnMask{1} << y;
+  }
+  changes++;
+}
+
+// Only rows the piece covers can have been completed by it. Surviving rows
+// between the piece and the top of the stack are moved down once each, by the
+// number of full rows below them. Cleared rows leave the hash and moved ones
+// trade the keys of their old row for those of their new one.
+int Grid::clear_full_rows(const FallingPiece& piece) {
+  const PieceMask& mask = piece_mask(piece);
+  const int top = piece.y + mask.top;
+  const int bottom = top + mask.height - 1;
+
+  int cleared_lines = 0;
+  int write = bottom;
+  for (int read = bottom; read >= int(stack_top); read--) {
+    if (read >= top && rows[read] == FULL_ROW) {
+      zobrist ^= zobrist::row(read, FULL_ROW);
+      // The rows cleared so far moved this one down in the column masks
+      ColumnMask below = ~ColumnMask{0} << (read + cleared_lines);
+      for (auto& column : columns)
+        column = (column & below << 1) | (column & ~below) << 1;
+      cleared_lines++;
+      continue;
+    }
+    if (write != read) {
+      zobrist ^= zobrist::row(read, rows[read]);
+      zobrist ^= zobrist::row(write, rows[read]);
+      rows[write] = rows[read];
+      cells[write] = cells[read];
+    }
+    write--;
+  }
+
+  for (int i = 0; i < cleared_lines; i++, stack_top++) {
+    rows[stack_top] = EMPTY_ROW;
+    cells[stack_top].fill(Tetromino::Empty);
+  }
+  changes += cleared_lines > 0;
+  return cleared_lines;
+}
+
+bool Grid::insert_garbage(int lines, int hole) {
+  lines = std::clamp(lines, 0, int(HEIGHT));
+  if (lines == 0)
+    return true;
+  const bool overflow = stack_top < std::size_t(lines);
+  const std::size_t first = std::max<std::size_t>(stack_top, lines);
+  std::copy(rows.begin() + first, rows.end(), rows.begin() + first - lines);
+  std::copy(cells.begin() + first, cells.end(), cells.begin() + first - lines);
+
+  const RowMask garbage = FULL_ROW & ~(1u << hole);
+  std::fill(rows.end() - lines, rows.end(), garbage);
+  std::for_each(cells.end() - lines, cells.end(), [](auto& row) {
+    row.fill(Tetromino::Empty);
+  });
+  const ColumnMask garbage_rows = ((ColumnMask{1} << lines) - 1)
+    << (HEIGHT - lines);
+  for (std::size_t x = 0; x < WIDTH; x++) {
+    columns[x] = (columns[x] & ~FLOOR) >> lines | FLOOR;
+    if (x != std::size_t(hole))
+      columns[x] |= garbage_rows;
+  }
+
+  stack_top = overflow ? 0 : stack_top - lines;
+  while (rows[stack_top] == EMPTY_ROW)
+    stack_top++;
+  // Every row of the stack moved
+  rehash();
+  changes++;
+  return !overflow;
+}
+
+bool Grid::empty() const {
+  return stack_top == HEIGHT;
+}
+
+// Row masks and the column masks, stack top and hash derived from them only
+// differ if the rows do
+bool Grid::operator==(const Grid& other) const {
+  return rows == other.rows && cells == other.cells;
+}
+
+// Empty rows take a single bit, others their mask plus 3 bits per filled cell
+void Grid::save(BitWriter& writer) const {
+  for (std::size_t y = 0; y < HEIGHT; y++) {
+    writer.write_bool(rows[y] != EMPTY_ROW);
+    if (rows[y] == EMPTY_ROW)
+      continue;
+    writer.write(rows[y], WIDTH);
+    for (std::size_t x = 0; x < WIDTH; x++)
+      if (rows[y] & (1u << x))
+        writer.write(std::to_underlying(cells[y][x]), 3);
+  }
+}
+
+void Grid::load(BitReader& reader) {
+  // Filled cells without a tetromino are garbage
+  auto last_tetromino = std::to_underlying(Tetromino::Empty);
+  stack_top = HEIGHT;
+  columns.fill(FLOOR);
+  for (std::size_t y = 0; y < HEIGHT; y++) {
+    rows[y] = reader.read_bool() ? reader.read(WIDTH) : EMPTY_ROW;
+    if (rows[y] != EMPTY_ROW)
+      stack_top = std::min(stack_top, y);
+    for (std::size_t x = 0; x < WIDTH; x++) {
+      cells[y][x] = rows[y] & (1u << x) ?
+        static_cast<Tetromino>(reader.read_at_most(3, last_tetromino)) :
+        Tetromino::Empty;
+      if (rows[y] & (1u << x))
+        columns[x] |= ColumnMask{1} << y;
+    }
+  }
+  rehash();
+  changes++;
+}
@@ -0,0 +1,25 @@
+#include "HandlingSettings.hpp"
+#include "Serialization.hpp"
+
+void HandlingSettings::save(BitWriter& writer) const {
+  for (int value :
+       {gravity,
+        soft_drop,
+        lock_delay_frames,
+        lock_delay_resets,
+        das,
+        arr,
+        dcd,
+        sdf})
+    writer.write_signed(value, 32);
+}
+
+void HandlingSettings::load(BitReader& reader, std::uint16_t version) {
+  for (int* value :
+       {&gravity, &soft_drop, &lock_delay_frames, &lock_delay_resets, &das})
+    *value = reader.read_signed(32);
+  if (version < save_file::TUNING_VERSION)
+    return;
+  for (int* value : {&arr, &dcd, &sdf})
+    *value = reader.read_signed(32);
+}
@@ -0,0 +1,6 @@
+#include "HudText.hpp"
+#include "raylib.h"
+
+int measure_text(const char* text, int font_size) {
+  return MeasureText(text, font_size);
+}
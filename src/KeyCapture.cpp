@@ -0,0 +1,63 @@
+#include "KeyCapture.hpp"
+#include "raylib.h"
+
+#if !defined(PLATFORM_WEB)
+// raylib builds GLFW in but does not ship its header, and its key codes are
+// GLFW's, so the callback is declared by hand
+extern "C" {
+struct GLFWwindow;
+using GLFWkeyfun = void (*)(GLFWwindow*, int, int, int, int);
+GLFWkeyfun glfwSetKeyCallback(GLFWwindow*, GLFWkeyfun);
+}
+
+namespace {
+constexpr int GLFW_RELEASE = 0;
+constexpr int GLFW_PRESS = 1;
+
+KeyEventQueue* hooked_queue = nullptr;
+GLFWkeyfun raylib_callback = nullptr;
+
+void key_callback(
+  GLFWwindow* window, int key, int scancode, int action, int mods
+) {
+  if (action == GLFW_PRESS || action == GLFW_RELEASE)
+    hooked_queue->push(
+      {key, action == GLFW_PRESS, std::chrono::steady_clock::now()}
+    );
+  if (raylib_callback)
+    raylib_callback(window, key, scancode, action, mods);
+}
+}; // namespace
+#endif
+
+KeyCapture::KeyCapture(KeyEventQueue& _queue) : queue(_queue) {
+#if !defined(PLATFORM_WEB)
+  if (auto window = static_cast<GLFWwindow*>(GetWindowHandle())) {
+    hooked_queue = &queue;
+    raylib_callback = glfwSetKeyCallback(window, key_callback);
+    hooked = true;
+  }
+#endif
+}
+
+KeyCapture::~KeyCapture() {
+#if !defined(PLATFORM_WEB)
+  if (hooked) {
+    auto window = static_cast<GLFWwindow*>(GetWindowHandle());
+    glfwSetKeyCallback(window, raylib_callback);
+    hooked_queue = nullptr;
+  }
+#endif
+}
+
+void KeyCapture::sample() {
+  if (hooked)
+    return;
+  const auto now = std::chrono::steady_clock::now();
+  for (int key = 1; key < KeyboardController::KEYS; key++) {
+    if (IsKeyPressed(key))
+      queue.push({key, true, now});
+    else if (IsKeyReleased(key))
+      queue.push({key, false, now});
+  }
+}
@@ -0,0 +1,26 @@
+#include "KeyboardController.hpp"
+
+KeyboardController::KeyboardController(const Bindings& _bindings) :
+  bindings(_bindings) {}
+
+Inputs KeyboardController::tick(std::span<const KeyEvent> events) {
+  Inputs inputs;
+  for (const KeyEvent& event : events) {
+    if (event.key <= 0 || event.key >= KEYS)
+      continue;
+    down[event.key] = event.down;
+    if (!event.down)
+      continue;
+    for (unsigned int action = 0; action < Inputs::BITS; action++) {
+      const auto [key, modifier] = bindings[action];
+      if (key == event.key && (modifier == 0 || down[modifier]))
+        inputs.set(static_cast<Action>(action));
+    }
+  }
+
+  Inputs still_down;
+  for (unsigned int action = 0; action < Inputs::BITS; action++)
+    if (bindings[action].key != 0 && down[bindings[action].key])
+      still_down.set(static_cast<Action>(action));
+  return Inputs(inputs.mask() | still_down.held().mask());
+}
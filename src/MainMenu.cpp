@@ -10,6 +10,10 @@ const char* to_string(MainMenu::Option option) {
     return "Single Player";
   case MainMenu::Option::TwoPlayers:
     return "Two Players";
+  case MainMenu::Option::VersusCpu:
+    return "Versus CPU";
+  case MainMenu::Option::Replay:
+    return "Watch Replay";
   case MainMenu::Option::Settings:
     return "Settings";
   case MainMenu::Option::Exit:
@@ -19,35 +23,33 @@ const char* to_string(MainMenu::Option option) {
 }
 }; // namespace
 
+MainMenu::MainMenu() {
+  for (int i = 0; i < int(option_labels.size()); i++)
+    option_labels[i] = HudLabel(to_string(static_cast<Option>(i)));
+}
+
 void MainMenu::draw() const {
   const int width = GetScreenWidth();
   const int height = GetScreenHeight();
-  const float font_size = height / 10.0f;
+  // Small enough for every option to fit below the title
+  const float font_size = height / (3.0f * option_labels.size());
   const float font_size_big = height / 4.0f;
 
   ClearBackground(LIGHTGRAY);
   DrawText(
-    "RAYTRIS",
-    (width - MeasureText("RAYTRIS", font_size_big)) / 2.0f,
+    title.c_str(),
+    (width - title.width(font_size_big)) / 2.0f,
     height / 2.0f - font_size_big - font_size,
     font_size_big,
     RED
   );
 
-  static constexpr auto OPTIONS = []() {
-    std::array<Option, std::to_underlying(Option::Exit)> res;
-    for (int i = 0; i < res.size(); i++) {
-      res[i] = static_cast<Option>(i);
-    }
-    return res;
-  }();
-
   const float boxWidth = 8.0f * font_size;
   const float separation = 1.5f * font_size;
   const float boxHeight = 1.3f * font_size;
-  for (int i = 0; i < OPTIONS.size(); i++) {
-    const auto s = to_string(OPTIONS[i]);
-    const bool isSelected = OPTIONS[i] == selectedOption;
+  for (int i = 0; i < int(option_labels.size()); i++) {
+    const HudLabel& label = option_labels[i];
+    const bool isSelected = static_cast<Option>(i) == selectedOption;
     const Rectangle box = {
       (width - boxWidth) / 2.0f,
       (height - boxHeight + font_size) / 2.0f + i * separation,
@@ -57,8 +59,8 @@ void MainMenu::draw() const {
     DrawRectangleRec(box, isSelected ? SKYBLUE : GRAY);
     DrawRectangleLinesEx(box, font_size / 10.0, isSelected ? BLUE : BLACK);
     DrawText(
-      s,
-      (width - MeasureText(s, font_size)) / 2.0,
+      label.c_str(),
+      (width - label.width(font_size)) / 2.0,
       height / 2.0 + i * separation,
       font_size,
       isSelected ? BLUE : BLACK
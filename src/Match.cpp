@@ -0,0 +1,99 @@
+#include "Match.hpp"
+#include <algorithm>
+#include <cassert>
+
+Match::Match(
+  std::size_t players, std::uint64_t seed, const HandlingSettings& _settings
+) :
+  settings(_settings),
+  // Another stream than the board seeds below, so the two never correlate
+  holes(seed, 1),
+  standing(players) {
+  Pcg32 seeds(seed);
+  boards.reserve(players);
+  for (std::size_t board = 0; board < players; board++)
+    boards.emplace_back(seeds.next_seed());
+}
+
+std::size_t Match::size() const {
+  return boards.size();
+}
+
+const Playfield& Match::operator[](std::size_t board) const {
+  return boards[board];
+}
+
+void Match::send(const Playfield& from, Playfield& to, Pcg32& holes) {
+  for (auto lines = from.attack(); lines > 0;) {
+    auto sent = std::min<unsigned int>(lines, Grid::HEIGHT);
+    to.receive_garbage(
+      {std::uint8_t(sent), std::uint8_t(holes.bounded(Grid::WIDTH))}
+    );
+    lines -= sent;
+  }
+}
+
+void Match::step(std::span<const Inputs> inputs) {
+  assert(inputs.size() == size());
+  if (over())
+    return;
+  for (std::size_t board = 0; board < size(); board++)
+    boards[board].update(inputs[board], settings);
+  frames++;
+
+  for (std::size_t board = 0; board < size(); board++) {
+    if (boards[board].attack() == 0)
+      continue;
+    for (std::size_t next = 1; next < size(); next++) {
+      Playfield& target = boards[(board + next) % size()];
+      if (!target.lost()) {
+        send(boards[board], target, holes);
+        break;
+      }
+    }
+  }
+
+  standing = std::ranges::count_if(boards, [](const Playfield& board) {
+    return !board.lost();
+  });
+}
+
+std::uint64_t Match::frame_count() const {
+  return frames;
+}
+
+bool Match::over() const {
+  return standing <= 1;
+}
+
+std::size_t Match::winner() const {
+  if (standing != 1)
+    return size();
+  for (std::size_t board = 0; board < size(); board++)
+    if (!boards[board].lost())
+      return board;
+  return size();
+}
+
+std::vector<MatchResult> play_matches(
+  ThreadPool& pool,
+  std::size_t matches,
+  std::size_t players,
+  std::uint64_t seed,
+  std::uint64_t max_frames,
+  const MatchPolicy& policy,
+  const HandlingSettings& settings
+) {
+  std::vector<MatchResult> results(matches);
+  pool.parallel_for(matches, [&](std::size_t index, unsigned) {
+    Match match(players, seed + index, settings);
+    std::vector<Inputs> inputs(players);
+    while (!match.over() && match.frame_count() < max_frames) {
+      for (std::size_t board = 0; board < players; board++)
+        inputs[board] = policy(index, match, board);
+      match.step(inputs);
+    }
+    results[index] = {match.winner(), match.frame_count()};
+  });
+  return results;
+}
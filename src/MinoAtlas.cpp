@@ -0,0 +1,108 @@
+#include "MinoAtlas.hpp"
+#include "DrawingDetails.hpp"
+#include "rlgl.h"
+#include <cmath>
+
+using DrawD = DrawingDetails;
+
+namespace {
+void bake_pretty(Rectangle rec, Color fill) {
+  float block_length = rec.width;
+  DrawRectangleRec(rec, fill);
+  DrawRectangle(
+    rec.x + block_length / 3,
+    rec.y + block_length / 3,
+    rec.width / 3,
+    rec.height / 3,
+    DrawD::DEFAULT_PRETTY_OUTLINE
+  );
+  DrawRectangleLinesEx(rec, block_length / 8, DrawD::DEFAULT_PRETTY_OUTLINE);
+}
+
+void bake_danger(Rectangle rec) {
+  float block_length = rec.width;
+  DrawRectangleLinesEx(rec, block_length / 8, {255, 0, 0, 150});
+  DrawLineEx(
+    {rec.x + rec.width * 0.25f, rec.y + rec.height * 0.25f},
+    {rec.x + rec.width * 0.75f, rec.y + rec.height * 0.75f},
+    block_length * 0.1f,
+    RED
+  );
+  DrawLineEx(
+    {rec.x + rec.width * 0.75f, rec.y + rec.height * 0.25f},
+    {rec.x + rec.width * 0.25f, rec.y + rec.height * 0.75f},
+    block_length * 0.1f,
+    {255, 0, 0, 150}
+  );
+}
+}; // namespace
+
+MinoStyle mino_style(Tetromino tetromino) {
+  return static_cast<MinoStyle>(std::to_underlying(tetromino));
+}
+
+MinoAtlas::MinoAtlas(float _block_length) :
+  block_length(_block_length),
+  stride(std::ceil(_block_length) + 1) {
+  RenderTexture2D target = LoadRenderTexture(stride * STYLES, stride);
+  BeginTextureMode(target);
+  ClearBackground(BLANK);
+  // Colors are stored premultiplied, so the translucent danger marks blend
+  // the same as they did when drawn straight to the screen
+  rlSetBlendFactorsSeparate(
+    RL_SRC_ALPHA,
+    RL_ONE_MINUS_SRC_ALPHA,
+    RL_ONE,
+    RL_ONE_MINUS_SRC_ALPHA,
+    RL_FUNC_ADD,
+    RL_FUNC_ADD
+  );
+  BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+  for (int style = 0; style < STYLES; style++) {
+    Rectangle cell{style * stride, 0, block_length, block_length};
+    switch (static_cast<MinoStyle>(style)) {
+    case MinoStyle::Garbage:
+      bake_pretty(cell, DrawD::GARBAGE_COLOR);
+      break;
+    case MinoStyle::Ghost:
+      bake_pretty(cell, DrawD::GHOST_COLOR);
+      break;
+    case MinoStyle::Unavailable:
+      bake_pretty(cell, DrawD::UNAVAILABLE_HOLD_PIECE_COLOR);
+      break;
+    case MinoStyle::Danger:
+      bake_danger(cell);
+      break;
+    default:
+      bake_pretty(cell, DrawD::TETROMINO_COLORS[style]);
+    }
+  }
+  EndBlendMode();
+  EndTextureMode();
+
+  // Render textures are stored upside down, flip it once instead of per quad
+  Image image = LoadImageFromTexture(target.texture);
+  ImageFlipVertical(&image);
+  texture = LoadTextureFromImage(image);
+  UnloadImage(image);
+  UnloadRenderTexture(target);
+}
+
+MinoAtlas::~MinoAtlas() {
+  UnloadTexture(texture);
+}
+
+void MinoAtlas::begin() const {
+  BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+}
+
+void MinoAtlas::draw(MinoStyle style, Vector2 position) const {
+  Rectangle source{
+    std::to_underlying(style) * stride, 0, block_length, block_length
+  };
+  DrawTextureRec(texture, source, position, WHITE);
+}
+
+void MinoAtlas::end() const {
+  EndBlendMode();
+}
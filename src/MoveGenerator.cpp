@@ -0,0 +1,268 @@
+#include "MoveGenerator.hpp"
+#include "PieceTables.hpp"
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace sr = std::ranges;
+
+namespace {
+constexpr std::array ROTATION_TYPES = {
+  RotationType::Clockwise,
+  RotationType::CounterClockwise,
+  RotationType::OneEighty,
+};
+
+constexpr std::array ROTATION_MOVES = {
+  MoveGenerator::Move::Clockwise,
+  MoveGenerator::Move::CounterClockwise,
+  MoveGenerator::Move::OneEighty,
+};
+
+// Orientations of I, S and Z that cover the same cells as a lower numbered
+// one, shifted by some offset. Mapping each to the lowest such orientation
+// lets placements be compared by their top left cell.
+constexpr auto CANONICAL = [] {
+  // Rows shifted so the leftmost column is bit 0
+  auto shape = [](const piece_tables::PieceMask& mask) {
+    auto rows = mask.rows;
+    for (auto& row : rows)
+      row >>= mask.left + piece_tables::MASK_ORIGIN;
+    return rows;
+  };
+  std::array<std::array<unsigned char, 4>, piece_tables::TETROMINOES> table{};
+  for (std::size_t t = 0; t < table.size(); t++)
+    for (std::size_t o = 0; o < 4; o++) {
+      table[t][o] = o;
+      for (std::size_t other = 0; other < o; other++)
+        if (shape(piece_tables::MASKS[t][other]) ==
+            shape(piece_tables::MASKS[t][o])) {
+          table[t][o] = other;
+          break;
+        }
+    }
+  return table;
+}();
+
+// Lowest mino of every column a piece covers, relative to the piece
+struct Bottoms {
+  signed char left;
+  signed char width;
+  std::array<signed char, 4> rows;
+};
+
+constexpr auto BOTTOMS = [] {
+  std::array<std::array<Bottoms, 4>, piece_tables::TETROMINOES> table{};
+  for (std::size_t t = 0; t < table.size(); t++)
+    for (std::size_t o = 0; o < 4; o++) {
+      const auto& map = piece_tables::MAPS[t][o];
+      const auto& mask = piece_tables::MASKS[t][o];
+      Bottoms& bottoms = table[t][o];
+      bottoms.left = mask.left;
+      bottoms.width = mask.right - mask.left + 1;
+      bottoms.rows.fill(-8);
+      for (auto coord : map) {
+        auto& row = bottoms.rows[coord.x - mask.left];
+        row = std::max<signed char>(row, coord.y);
+      }
+    }
+  return table;
+}();
+
+std::size_t placement_index(
+  Tetromino tetromino, int x, int y, Orientation orientation, SpinType spin
+) {
+  const auto& mask = piece_tables::mask(tetromino, orientation);
+  std::size_t left = x + mask.left;
+  std::size_t top = y + mask.top;
+  auto canonical = CANONICAL[std::to_underlying(tetromino)]
+                            [std::to_underlying(orientation)];
+  return ((top * Grid::WIDTH + left) * 4 + canonical) * 3 +
+    std::to_underlying(spin);
+}
+}; // namespace
+
+// Every node is visited once and every placement reported once
+MoveGenerator::MoveGenerator() {
+  nodes.reserve(visited.size());
+  placements.reserve(MAX_PLACEMENTS);
+}
+
+bool MoveGenerator::fits(int x, int y, Orientation orientation) const {
+  const auto& mask = piece_tables::mask(tetromino, orientation);
+  const auto* rows = &board[y + mask.top + PADDING];
+  int shift = x - piece_tables::MASK_ORIGIN + WALL;
+  for (int i = 0; i < mask.height; i++)
+    if (rows[i] & std::uint32_t{mask.rows[i]} << shift)
+      return false;
+  return true;
+}
+
+// Every cell between a column's lowest mino and the next filled cell below it
+// is free, so the piece falls by the smallest of those gaps
+int MoveGenerator::landing_row(const Node& node) const {
+  const auto& bottoms = BOTTOMS[std::to_underlying(tetromino)]
+                               [std::to_underlying(node.orientation)];
+  int distance = Grid::HEIGHT;
+  for (int i = 0; i < bottoms.width; i++) {
+    int row = node.y + bottoms.rows[i];
+    auto below = columns[node.x + bottoms.left + i] >> (row + 1);
+    distance = std::min(distance, std::countr_zero(below));
+  }
+  return node.y + distance;
+}
+
+void MoveGenerator::visit(Node node) {
+  std::size_t index = (node.x + X_OFFSET) * Y_RANGE + node.y + Y_OFFSET;
+  index = (index * 4 + std::to_underlying(node.orientation)) * 2 + node.rotated;
+  if (visited[index])
+    return;
+  visited[index] = true;
+  nodes.push_back(node);
+}
+
+FallingPiece MoveGenerator::piece(const Node& node) const {
+  FallingPiece piece(tetromino, node.x, node.y);
+  piece.orientation = node.orientation;
+  piece.map = piece_tables::map(tetromino, node.orientation);
+  return piece;
+}
+
+void MoveGenerator::add_placement(
+  const Node& node, SpinType spin, std::uint16_t index
+) {
+  auto key = placement_index(tetromino, node.x, node.y, node.orientation, spin);
+  if (placed[key])
+    return;
+  placed[key] = true;
+  placements.push_back({piece(node), spin, index});
+}
+
+std::span<const MoveGenerator::Placement>
+MoveGenerator::generate(const Grid& grid, const FallingPiece& start) {
+  nodes.clear();
+  visited.reset();
+  placed.reset();
+  placements.clear();
+
+  tetromino = start.tetromino;
+  const std::uint32_t walls = ~(std::uint32_t{Grid::FULL_ROW} << WALL);
+  board.fill(~std::uint32_t{0});
+  for (std::size_t y = 0; y < Grid::HEIGHT; y++)
+    board[y + PADDING] = walls | std::uint32_t{grid.row_mask(y)} << WALL;
+  for (std::size_t x = 0; x < Grid::WIDTH; x++)
+    columns[x] = grid.column_mask(x);
+  if (!fits(start.x, start.y, start.orientation))
+    return placements;
+
+  // Breadth first, so the first path to reach a placement is the shortest
+  visit({start.x, start.y, start.orientation, false, Move::HardDrop, NO_PARENT}
+  );
+  for (std::uint16_t i = 0; i < nodes.size(); i++) {
+    const Node node = nodes[i];
+
+    Node landed = node;
+    landed.y = landing_row(node);
+    if (landed.y == node.y) {
+      bool spin = node.rotated && tetromino == Tetromino::T;
+      add_placement(
+        node, spin ? is_spin(piece(node), grid) : SpinType::No, i
+      );
+    } else {
+      // Moving down clears the rotation flag, hard drop or not
+      landed.rotated = false;
+      landed.move = Move::SoftDrop;
+      landed.parent = i;
+      add_placement(landed, SpinType::No, i);
+      visit(landed);
+    }
+
+    for (auto [dx, move] : {std::pair{-1, Move::Left}, {1, Move::Right}})
+      if (fits(node.x + dx, node.y, node.orientation))
+        visit({
+          static_cast<signed char>(node.x + dx),
+          node.y,
+          node.orientation,
+          false,
+          move,
+          i
+        });
+
+    for (std::size_t r = 0; r < ROTATION_TYPES.size(); r++) {
+      const auto& rotation = piece_tables::rotation(
+        tetromino, node.orientation, ROTATION_TYPES[r]
+      );
+      for (auto kick : rotation.kicks) {
+        int x = node.x + kick.x;
+        int y = node.y + kick.y;
+        if (fits(x, y, rotation.orientation)) {
+          visit({
+            static_cast<signed char>(x),
+            static_cast<signed char>(y),
+            rotation.orientation,
+            true,
+            ROTATION_MOVES[r],
+            i
+          });
+          break;
+        }
+      }
+    }
+  }
+
+  return placements;
+}
+
+std::vector<MoveGenerator::Move>
+MoveGenerator::moves(const Placement& placement) const {
+  std::vector<Move> result{Move::HardDrop};
+  for (auto node = placement.node; nodes[node].parent != NO_PARENT;
+       node = nodes[node].parent) {
+    const Node& parent = nodes[nodes[node].parent];
+    // One soft drop per row fallen
+    int rows =
+      nodes[node].move == Move::SoftDrop ? nodes[node].y - parent.y : 1;
+    result.insert(result.end(), rows, nodes[node].move);
+  }
+  sr::reverse(result);
+  return result;
+}
+
+// Walks the path back from the placement and reverses it, like moves(), but
+// with a soft drop node standing for the whole run of rows it fell
+void MoveGenerator::inputs(
+  const Placement& placement,
+  const HandlingSettings& settings,
+  std::vector<Inputs>& result
+) const {
+  static constexpr std::array<Action, 7> ACTIONS = {
+    Action::Left,
+    Action::Right,
+    Action::Clockwise,
+    Action::CounterClockwise,
+    Action::OneEighty,
+    Action::SoftDrop,
+    Action::HardDrop,
+  };
+  auto frame = [](Move move) {
+    Inputs inputs;
+    inputs.set(ACTIONS[std::to_underlying(move)]);
+    return inputs;
+  };
+  result.assign(1, frame(Move::HardDrop));
+  for (auto node = placement.node; nodes[node].parent != NO_PARENT;
+       node = nodes[node].parent) {
+    const Node& parent = nodes[nodes[node].parent];
+    int frames = 1;
+    if (nodes[node].move == Move::SoftDrop) {
+      // A soft drop always lands, so it moves sdf rows every soft_drop
+      // frames until it has covered all the rows
+      int rows = nodes[node].y - parent.y;
+      int sdf = settings.sdf;
+      int steps = sdf <= 0 ? 1 : (rows + sdf - 1) / sdf;
+      frames = steps * std::max(settings.soft_drop, 1);
+    }
+    result.insert(result.end(), frames, frame(nodes[node].move));
+  }
+  sr::reverse(result);
+}
@@ -1,32 +1,128 @@
 #include "NextQueue.hpp"
 #include "FallingPiece.hpp"
+#include "Serialization.hpp"
 #include <algorithm>
-#include <random>
+#include <utility>
 
 using enum Tetromino;
-static std::mt19937 generator = std::mt19937((std::random_device())());
-static constexpr std::array<Tetromino, NextQueue::SIZE_OF_BAG> new_bag = {
-  I, O, T, S, Z, J, L
-};
-
-NextQueue::NextQueue() : queue_size{SIZE_OF_BAG} {
-  std::ranges::copy(new_bag, queue.begin());
-  std::shuffle(queue.begin(), queue.begin() + SIZE_OF_BAG, generator);
-}
-
-Tetromino NextQueue::next_tetromino() {
-  Tetromino next = queue[--queue_size];
-  if (queue_size <= NEXT_SIZE) {
-    for (std::size_t index = queue_size; index >= 1; index--)
-      queue[index + SIZE_OF_BAG - 1] = queue[index - 1];
-    for (std::size_t index = 0; index < SIZE_OF_BAG; index++)
-      queue[index] = new_bag[index];
-    queue_size += SIZE_OF_BAG;
-    std::shuffle(queue.begin(), queue.begin() + SIZE_OF_BAG, generator);
+static constexpr std::size_t TETROMINOS = std::to_underlying(Empty);
+static constexpr auto LAST_TETROMINO = TETROMINOS - 1;
+
+static Tetromino load_tetromino(BitReader& reader) {
+  return static_cast<Tetromino>(reader.read_at_most(3, LAST_TETROMINO));
+}
+
+template <std::size_t COPIES>
+Tetromino Bag<COPIES>::next(Pcg32& generator) {
+  if (remaining == 0) {
+    for (std::size_t index = 0; index < SIZE; index++)
+      bag[index] = static_cast<Tetromino>(index % TETROMINOS);
+    remaining = SIZE;
+  }
+  // Draw without replacement, which is a lazy Fisher-Yates shuffle
+  std::swap(bag[generator.bounded(remaining)], bag[remaining - 1]);
+  return bag[--remaining];
+}
+
+template <std::size_t COPIES>
+void Bag<COPIES>::save(BitWriter& writer) const {
+  writer.write(remaining, 4);
+  for (std::size_t index = 0; index < remaining; index++)
+    writer.write(std::to_underlying(bag[index]), 3);
+}
+
+template <std::size_t COPIES>
+void Bag<COPIES>::load(BitReader& reader) {
+  remaining = reader.read_at_most(4, SIZE);
+  for (std::size_t index = 0; index < remaining; index++)
+    bag[index] = load_tetromino(reader);
+}
+
+template class Bag<1>;
+template class Bag<2>;
+
+Tetromino ClassicRandom::next(Pcg32& generator) {
+  return static_cast<Tetromino>(generator.bounded(TETROMINOS));
+}
+
+void ClassicRandom::save(BitWriter&) const {}
+
+void ClassicRandom::load(BitReader&) {}
+
+Tetromino TgmHistory::next(Pcg32& generator) {
+  Tetromino next;
+  if (first) {
+    static constexpr std::array<Tetromino, 4> FIRST_PIECES = {I, T, J, L};
+    next = FIRST_PIECES[generator.bounded(FIRST_PIECES.size())];
+    first = false;
+  } else {
+    for (int roll = 0; roll < ROLLS; roll++) {
+      next = static_cast<Tetromino>(generator.bounded(TETROMINOS));
+      if (std::ranges::find(history, next) == history.end())
+        break;
+    }
   }
+  std::shift_right(history.begin(), history.end(), 1);
+  history.front() = next;
   return next;
 }
 
-const Tetromino& NextQueue::operator[](std::size_t index) const {
-  return queue[queue_size - 1 - index];
+void TgmHistory::save(BitWriter& writer) const {
+  for (Tetromino tetromino : history)
+    writer.write(std::to_underlying(tetromino), 3);
+  writer.write_bool(first);
 }
+
+void TgmHistory::load(BitReader& reader) {
+  for (Tetromino& tetromino : history)
+    tetromino = load_tetromino(reader);
+  first = reader.read_bool();
+}
+
+template <class Randomizer>
+BasicNextQueue<Randomizer>::BasicNextQueue(std::uint64_t seed) :
+  generator(seed) {
+  for (Tetromino& tetromino : queue)
+    tetromino = randomizer.next(generator);
+}
+
+template <class Randomizer>
+Tetromino BasicNextQueue<Randomizer>::next_tetromino() {
+  Tetromino next = queue[front];
+  queue[front] = randomizer.next(generator);
+  front = (front + 1) % NEXT_SIZE;
+  return next;
+}
+
+template <class Randomizer>
+const Tetromino& BasicNextQueue<Randomizer>::operator[](std::size_t index
+) const {
+  return queue[(front + index) % NEXT_SIZE];
+}
+
+template <class Randomizer>
+std::uint64_t BasicNextQueue<Randomizer>::next_seed() {
+  return generator.next_seed();
+}
+
+template <class Randomizer>
+void BasicNextQueue<Randomizer>::save(BitWriter& writer) const {
+  for (std::size_t index = 0; index < NEXT_SIZE; index++)
+    writer.write(std::to_underlying((*this)[index]), 3);
+  generator.save(writer);
+  randomizer.save(writer);
+}
+
+template <class Randomizer>
+void BasicNextQueue<Randomizer>::load(BitReader& reader) {
+  front = 0;
+  for (Tetromino& tetromino : queue)
+    tetromino = load_tetromino(reader);
+  generator.load(reader);
+  randomizer.load(reader);
+}
+
+template class BasicNextQueue<SevenBag>;
+template class BasicNextQueue<FourteenBag>;
+template class BasicNextQueue<ClassicRandom>;
+template class BasicNextQueue<TgmHistory>;
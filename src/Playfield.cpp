@@ -1,33 +1,32 @@
 #include "Playfield.hpp"
 #include "FallingPiece.hpp"
-#include "raylib.h"
+#include "PieceTables.hpp"
+#include "Profiler.hpp"
+#include "Serialization.hpp"
+#include "Zobrist.hpp"
 #include <algorithm>
-#include <cmath>
-#include <format>
 #include <ranges>
 #include <utility>
 
 namespace sr = std::ranges;
 namespace sv = std::views;
-using Ctrlr = Controller;
 using HandS = HandlingSettings;
-using DrawD = DrawingDetails;
 
-static constexpr std::size_t INITIAL_X_POSITION = (Playfield::WIDTH - 1) / 2;
-static constexpr std::size_t INITIAL_Y_POSITION = Playfield::VISIBLE_HEIGHT - 1;
 static FallingPiece spawn_tetromino(Tetromino tetromino) {
-  return FallingPiece(tetromino, INITIAL_X_POSITION, INITIAL_Y_POSITION);
+  return FallingPiece(
+    tetromino, Playfield::INITIAL_X_POSITION, Playfield::INITIAL_Y_POSITION
+  );
 }
 
-Playfield::Playfield() :
-  next_queue(),
-  falling_piece(spawn_tetromino(next_queue.next_tetromino())) {
-  sr::for_each(grid, [](auto& row) { row.fill(Tetromino::Empty); });
-}
+Playfield::Playfield(std::uint64_t seed) :
+  next_queue(seed),
+  falling_piece(spawn_tetromino(next_queue.next_tetromino())),
+  locked_piece(falling_piece),
+  state_hash(rehash()) {}
 
 void Playfield::restart() {
   auto last_score = this->score;
-  *this = Playfield();
+  *this = Playfield(next_queue.next_seed());
   this->score = last_score;
 }
 
@@ -35,19 +34,224 @@ bool Playfield::lost() const {
   return has_lost;
 }
 
-static bool valid_mino(int x, int y) {
-  return x >= 0 && x < Playfield::WIDTH && y >= 0 && y < Playfield::HEIGHT;
+unsigned long Playfield::get_score() const {
+  return score;
 }
 
-static bool valid_position(const auto& grid, const FallingPiece& piece) {
-  return sr::all_of(piece.map, [&](auto coord) {
-    int x = piece.x + coord.x;
-    int y = piece.y + coord.y;
-    return valid_mino(x, y) && grid[y][x] == Tetromino::Empty;
-  });
+unsigned int Playfield::attack() const {
+  return sent_lines;
+}
+
+const GarbageQueue& Playfield::incoming_garbage() const {
+  return incoming;
+}
+
+void Playfield::receive_garbage(GarbageAttack attack) {
+  incoming.push(attack);
+}
+
+std::uint64_t Playfield::hash() const {
+  return grid.hash() ^ state_hash;
+}
+
+bool Playfield::operator==(const Playfield& other) const {
+  if (hash() != other.hash())
+    return false;
+  for (std::size_t i = 0; i < NextQueue::NEXT_SIZE; i++)
+    if (next_queue[i] != other.next_queue[i])
+      return false;
+  return sr::equal(grid.row_masks(), other.grid.row_masks()) &&
+    falling_piece.tetromino == other.falling_piece.tetromino &&
+    holding_piece == other.holding_piece && can_swap == other.can_swap &&
+    combo == other.combo && b2b == other.b2b;
+}
+
+std::uint64_t Playfield::pieces_hash() const {
+  const auto& keys = zobrist::KEYS.pieces;
+  std::uint64_t hash = keys[0][std::to_underlying(falling_piece.tetromino)];
+  for (std::size_t i = 0; i < NextQueue::NEXT_SIZE; i++)
+    hash ^= keys[i + 1][std::to_underlying(next_queue[i])];
+  return hash;
+}
+
+// From scratch, for states that are not reached one change at a time
+std::uint64_t Playfield::rehash() const {
+  const auto& keys = zobrist::KEYS;
+  return pieces_hash() ^ keys.hold[std::to_underlying(holding_piece)] ^
+    (can_swap ? keys.can_swap : 0) ^ zobrist::count(keys.combo, combo) ^
+    zobrist::count(keys.b2b, b2b);
+}
+
+// Every piece of the preview moves up a slot
+void Playfield::spawn_next() {
+  state_hash ^= pieces_hash();
+  falling_piece = spawn_tetromino(next_queue.next_tetromino());
+  state_hash ^= pieces_hash();
+}
+
+int Playfield::ghost_y() const {
+  const FallingPiece& piece = falling_piece;
+  if (ghost.tetromino != piece.tetromino ||
+      ghost.orientation != piece.orientation || ghost.x != piece.x ||
+      ghost.y != piece.y || ghost.grid_revision != grid.revision())
+    ghost = {
+      piece.tetromino,
+      piece.orientation,
+      piece.x,
+      piece.y,
+      grid.revision(),
+      piece.y + grid.drop_distance(piece)
+    };
+  return ghost.landing_y;
+}
+
+bool Playfield::in_danger() const {
+  static constexpr Grid::RowMask DANGER_COLUMNS = 0b1111 << (WIDTH / 2 - 2);
+  static constexpr auto DANGER_ROWS =
+    sv::iota(INITIAL_Y_POSITION, INITIAL_Y_POSITION + 5);
+  if (danger.grid_revision != grid.revision())
+    danger = {grid.revision(), sr::any_of(DANGER_ROWS, [this](auto y) {
+                return (grid.row_mask(y) & DANGER_COLUMNS) != Grid::EMPTY_ROW;
+              })};
+  return danger.in_danger;
+}
+
+PieceLock Playfield::last_lock() const {
+  return {
+    locked_piece,
+    falling_piece.tetromino,
+    holding_piece,
+    has_lost,
+    message,
+    combo,
+    b2b,
+    score,
+    next_queue
+  };
+}
+
+bool Playfield::can_replay(const PieceLock& lock) const {
+  return grid.fits(lock.locked_piece);
+}
+
+void Playfield::replay(const PieceLock& lock) {
+  grid.place(lock.locked_piece);
+  grid.clear_full_rows(lock.locked_piece);
+  locked_piece = lock.locked_piece;
+  falling_piece = spawn_tetromino(lock.spawned_piece);
+  holding_piece = lock.holding_piece;
+  has_lost = lock.has_lost;
+  message = lock.message;
+  combo = lock.combo;
+  b2b = lock.b2b;
+  score = lock.score;
+  next_queue = lock.next_queue;
+  can_swap = true;
+  frames_since_drop = 0;
+  lock_delay_frames = 0;
+  lock_delay_resets = 0;
+  frames_pressed = 0;
+  das_cut_frames = 0;
+  last_move_rotation = false;
+  state_hash = rehash();
 }
 
-static SpinType is_spin(const FallingPiece& piece, auto&& grid) {
+static void save_message(BitWriter& writer, const LineClearMessage& message) {
+  writer.write(std::to_underlying(message.message), 3);
+  writer.write(message.timer, 8);
+  writer.write(std::to_underlying(message.spin_type), 2);
+}
+
+static LineClearMessage load_message(BitReader& reader) {
+  LineClearMessage message;
+  auto last_message = std::to_underlying(MessageType::AllClear);
+  auto last_spin = std::to_underlying(SpinType::Proper);
+  auto type = reader.read_at_most(3, last_message);
+  message.message = static_cast<MessageType>(type);
+  message.timer = reader.read(8);
+  message.spin_type = static_cast<SpinType>(reader.read_at_most(2, last_spin));
+  return message;
+}
+
+static Tetromino load_holding_piece(BitReader& reader) {
+  auto empty = std::to_underlying(Tetromino::Empty);
+  return static_cast<Tetromino>(reader.read_at_most(3, empty));
+}
+
+void PieceLock::save(BitWriter& writer) const {
+  locked_piece.save(writer);
+  writer.write(std::to_underlying(spawned_piece), 3);
+  writer.write(std::to_underlying(holding_piece), 3);
+  writer.write_bool(has_lost);
+  save_message(writer, message);
+  writer.write(combo, 32);
+  writer.write(b2b, 32);
+  writer.write(score, 64);
+  next_queue.save(writer);
+}
+
+void PieceLock::load(BitReader& reader) {
+  locked_piece.load(reader);
+  auto last_tetromino = std::to_underlying(Tetromino::Empty) - 1;
+  auto spawned = reader.read_at_most(3, last_tetromino);
+  spawned_piece = static_cast<Tetromino>(spawned);
+  holding_piece = load_holding_piece(reader);
+  has_lost = reader.read_bool();
+  message = load_message(reader);
+  combo = reader.read(32);
+  b2b = reader.read(32);
+  score = reader.read(64);
+  next_queue.load(reader);
+}
+
+void Playfield::save(BitWriter& writer) const {
+  grid.save(writer);
+  next_queue.save(writer);
+  falling_piece.save(writer);
+  locked_piece.save(writer);
+  writer.write(std::to_underlying(holding_piece), 3);
+  writer.write_bool(can_swap);
+  writer.write(frames_since_drop, 32);
+  writer.write(lock_delay_frames, 32);
+  writer.write(lock_delay_resets, 32);
+  writer.write_signed(frames_pressed, 32);
+  writer.write(das_cut_frames, 32);
+  writer.write(combo, 32);
+  writer.write_bool(has_lost);
+  writer.write(score, 64);
+  writer.write(b2b, 32);
+  writer.write_bool(last_move_rotation);
+  save_message(writer, message);
+  incoming.save(writer);
+  writer.write(sent_lines, 32);
+}
+
+void Playfield::load(BitReader& reader) {
+  grid.load(reader);
+  next_queue.load(reader);
+  falling_piece.load(reader);
+  locked_piece.load(reader);
+  holding_piece = load_holding_piece(reader);
+  can_swap = reader.read_bool();
+  frames_since_drop = reader.read(32);
+  lock_delay_frames = reader.read(32);
+  lock_delay_resets = reader.read(32);
+  frames_pressed = reader.read_signed(32);
+  das_cut_frames = reader.read(32);
+  combo = reader.read(32);
+  has_lost = reader.read_bool();
+  score = reader.read(64);
+  b2b = reader.read(32);
+  last_move_rotation = reader.read_bool();
+  message = load_message(reader);
+  incoming.load(reader);
+  sent_lines = reader.read(32);
+  state_hash = rehash();
+  if (!has_lost && !grid.fits(falling_piece))
+    reader.fail();
+}
+
+SpinType is_spin(const FallingPiece& piece, const Grid& grid) {
   if (piece.tetromino != Tetromino::T)
     return SpinType::No;
 
@@ -57,13 +261,13 @@ static SpinType is_spin(const FallingPiece& piece, auto&& grid) {
   auto front_count = sr::count_if(sv::take(corners, 2), [&](auto coord) {
     int x = piece.x + coord.x;
     int y = piece.y + coord.y;
-    return !valid_mino(x, y) || grid[y][x] != Tetromino::Empty;
+    return grid.occupied(x, y);
   });
 
   auto back_count = sr::count_if(sv::drop(corners, 2), [&](auto coord) {
     int x = piece.x + coord.x;
     int y = piece.y + coord.y;
-    return !valid_mino(x, y) || grid[y][x] != Tetromino::Empty;
+    return grid.occupied(x, y);
   });
 
   if (front_count + back_count < 3)
@@ -73,30 +277,50 @@ static SpinType is_spin(const FallingPiece& piece, auto&& grid) {
   return SpinType::Mini;
 }
 
+// Guideline style: clears and spins by the table, one more for keeping back
+// to back going, then the combo bonus and all clears
+unsigned int attack_lines(
+  int cleared_lines, SpinType spin_type, unsigned int combo, unsigned int b2b,
+  bool all_clear
+) {
+  static constexpr std::array<std::array<unsigned int, 5>, 3> attack_table = {{
+    /* cleared:  0  1  2  3  4 */
+    /*NoSpin */ {0, 0, 1, 2, 4},
+    /*Mini   */ {0, 0, 1, 0, 0},
+    /*Proper */ {0, 2, 4, 6, 0},
+  }};
+  static constexpr std::array<unsigned int, 12> combo_table = {
+    0, 0, 1, 1, 1, 2, 2, 3, 3, 4, 4, 4
+  };
+  if (cleared_lines == 0)
+    return 0;
+  auto lines = attack_table[std::to_underlying(spin_type)][cleared_lines];
+  bool difficult = cleared_lines == 4 || spin_type != SpinType::No;
+  if (difficult && b2b >= 2)
+    lines += 1;
+  lines += combo_table[std::min<std::size_t>(combo, combo_table.size() - 1)];
+  if (all_clear)
+    lines += 10;
+  return lines;
+}
+
 void Playfield::solidify_piece() {
+  RAYTRIS_PROFILE_SCOPE("Playfield::solidify_piece");
   bool topped_out = true;
 
-  for (auto coord : falling_piece.map) {
-    int x = coord.x + falling_piece.x;
-    int y = coord.y + falling_piece.y;
-    grid[y][x] = falling_piece.tetromino;
-
-    if (y >= VISIBLE_HEIGHT)
+  for (auto coord : falling_piece.map)
+    if (coord.y + falling_piece.y >= int(VISIBLE_HEIGHT))
       topped_out = false;
-  }
+  grid.place(falling_piece);
+  locked_piece = falling_piece;
 
   SpinType spin_type =
     last_move_rotation ? is_spin(falling_piece, grid) : SpinType::No;
 
-  int cleared_lines = 0;
-  for (std::size_t row_idx = 0; row_idx < HEIGHT; row_idx++) {
-    if (sr::any_of(grid[row_idx], [](auto m) { return m == Tetromino::Empty; }))
-      continue;
-    sr::copy_backward(sv::take(grid, row_idx), grid.begin() + row_idx + 1);
-    grid.front().fill(Tetromino::Empty);
-    cleared_lines++;
-  }
+  int cleared_lines = grid.clear_full_rows(falling_piece);
 
+  state_hash ^= zobrist::count(zobrist::KEYS.combo, combo) ^
+    zobrist::count(zobrist::KEYS.b2b, b2b);
   if (cleared_lines == 0) {
     combo = 0;
   } else {
@@ -106,6 +330,8 @@ void Playfield::solidify_piece() {
     else
       b2b = 0;
   }
+  state_hash ^= zobrist::count(zobrist::KEYS.combo, combo) ^
+    zobrist::count(zobrist::KEYS.b2b, b2b);
 
   score += combo * 50;
   int b2b_factor = (b2b >= 2) ? 3 : 2;
@@ -121,147 +347,169 @@ void Playfield::solidify_piece() {
   message = static_cast<MessageType>(cleared_lines);
   message.spin_type = spin_type;
 
-  bool is_all_clear = sr::all_of(grid, [](const auto& row) {
-    return sr::all_of(row, [](Tetromino mino) {
-      return mino == Tetromino::Empty;
-    });
-  });
-
-  if (is_all_clear) {
+  if (grid.empty()) {
     message.message = MessageType::AllClear;
     score += 3500 * b2b_factor / 2;
   }
 
-  Tetromino next_tetromino = next_queue.next_tetromino();
-  falling_piece = spawn_tetromino(next_tetromino);
+  // Sent lines cancel incoming garbage first, the rest rises when nothing
+  // was cleared
+  auto lines = attack_lines(cleared_lines, spin_type, combo, b2b, grid.empty());
+  sent_lines += incoming.cancel(lines);
+  for (auto cap = GARBAGE_CAP; cleared_lines == 0 && cap > 0;) {
+    GarbageAttack attack = incoming.pop(cap);
+    if (attack.lines == 0)
+      break;
+    if (!grid.insert_garbage(attack.lines, attack.hole))
+      topped_out = true;
+    cap -= attack.lines;
+  }
+
+  spawn_next();
   frames_since_drop = 0;
   lock_delay_frames = 0;
   lock_delay_resets = 0;
+  if (!can_swap)
+    state_hash ^= zobrist::KEYS.can_swap;
   can_swap = true;
 
-  bool can_spawn_piece = sr::all_of(falling_piece.map, [&](auto coord) {
-    int x = coord.x + falling_piece.x;
-    int y = coord.y + falling_piece.y;
-    return grid[y][x] == Tetromino::Empty;
-  });
-
-  has_lost = topped_out || !can_spawn_piece;
+  has_lost = topped_out || !grid.fits(falling_piece);
 }
 
-void Playfield::handle_swap(const Ctrlr& ctrlr) {
-  if (!ctrlr.swap() || !can_swap)
+void Playfield::handle_swap(Inputs inputs) {
+  RAYTRIS_PROFILE_SCOPE("Playfield::handle_swap");
+  if (!inputs[Action::Swap] || !can_swap)
     return;
 
+  const auto& keys = zobrist::KEYS;
   Tetromino currentTetromino = falling_piece.tetromino;
-  if (holding_piece != Tetromino::Empty)
+  if (holding_piece != Tetromino::Empty) {
+    state_hash ^= keys.pieces[0][std::to_underlying(currentTetromino)] ^
+      keys.pieces[0][std::to_underlying(holding_piece)];
     falling_piece = spawn_tetromino(holding_piece);
-  else
-    falling_piece = spawn_tetromino(next_queue.next_tetromino());
+  } else {
+    spawn_next();
+  }
+  state_hash ^= keys.hold[std::to_underlying(holding_piece)] ^
+    keys.hold[std::to_underlying(currentTetromino)] ^ keys.can_swap;
   holding_piece = currentTetromino;
   can_swap = false;
   frames_since_drop = 0;
   lock_delay_frames = 0;
   lock_delay_resets = 0;
   last_move_rotation = false;
+  // Swapping into the stack blocks out, same as a spawn after a lock
+  has_lost = !grid.fits(falling_piece);
 }
 
-void Playfield::handle_shifts(const Ctrlr& ctrlr, const HandS& hand_set) {
-  auto try_shifting = [this](Shift shift) {
-    const FallingPiece shiftedPiece = falling_piece.shifted(shift);
-    if (valid_position(grid, shiftedPiece)) {
-      falling_piece = shiftedPiece;
-      lock_delay_frames = 0;
-      lock_delay_resets += 1;
-      last_move_rotation = false;
-    }
+void Playfield::handle_shifts(Inputs inputs, const HandS& hand_set) {
+  RAYTRIS_PROFILE_SCOPE("Playfield::handle_shifts");
+  auto shift_by = [this](Shift shift, int distance) {
+    if (distance == 0)
+      return;
+    falling_piece.x += shift == Shift::Left ? -distance : distance;
+    lock_delay_frames = 0;
+    lock_delay_resets += distance;
+    last_move_rotation = false;
   };
-  auto try_das = [this](Shift shift) {
-    FallingPiece shiftedPiece = falling_piece.shifted(shift);
-    while (valid_position(grid, shiftedPiece)) {
-      falling_piece = shiftedPiece;
-      lock_delay_frames = 0;
-      lock_delay_resets += 1;
-      last_move_rotation = false;
-      shiftedPiece = falling_piece.shifted(shift);
-    }
+  auto try_shifting = [&](Shift shift) {
+    shift_by(shift, std::min(grid.shift_distance(falling_piece, shift), 1));
+  };
+  // Auto shift starts the tick after DAS charges and repeats every ARR
+  // ticks, all the way to the wall when ARR is 0
+  auto auto_shift = [&](Shift shift, int held) {
+    if (held <= hand_set.das || das_cut_frames > 0)
+      return;
+    if (hand_set.arr <= 0)
+      shift_by(shift, grid.shift_distance(falling_piece, shift));
+    else if ((held - hand_set.das - 1) % hand_set.arr == 0)
+      try_shifting(shift);
   };
 
-  if (ctrlr.left())
+  if (inputs[Action::Left])
     try_shifting(Shift::Left);
-  else if (ctrlr.right())
+  else if (inputs[Action::Right])
     try_shifting(Shift::Right);
 
-  if (ctrlr.left_das()) {
+  if (inputs[Action::LeftDas]) {
     frames_pressed = std::max(0, frames_pressed) + 1;
-    if (frames_pressed > hand_set.das)
-      try_das(Shift::Left);
-  } else if (ctrlr.right_das()) {
+    auto_shift(Shift::Left, frames_pressed);
+  } else if (inputs[Action::RightDas]) {
     frames_pressed = std::min(0, frames_pressed) - 1;
-    if (-frames_pressed > hand_set.das)
-      try_das(Shift::Right);
+    auto_shift(Shift::Right, -frames_pressed);
   } else {
     frames_pressed = 0;
   }
+  // Counted down after the check, so a cut of n holds off n ticks
+  if (das_cut_frames > 0)
+    das_cut_frames -= 1;
 }
 
-void Playfield::handle_rotations(const Ctrlr& ctrlr) {
-  auto try_rotating = [this](RotationType rotationType) {
-    const FallingPiece rotated_piece = falling_piece.rotated(rotationType);
-    auto offsets = sv::transform(
-      sv::zip(offset_table(falling_piece), offset_table(rotated_piece)),
-      [](auto ps) {
-        auto [p1, p2] = ps;
-        return CoordinatePair(p1.x - p2.x, p1.y - p2.y);
-      }
+void Playfield::handle_rotations(Inputs inputs, const HandS& hand_set) {
+  RAYTRIS_PROFILE_SCOPE("Playfield::handle_rotations");
+  auto try_rotating = [&](RotationType rotationType) {
+    const auto& rotation = piece_tables::rotation(
+      falling_piece.tetromino, falling_piece.orientation, rotationType
     );
-    auto valid_offset = sr::find_if(offsets, [&](auto offset) {
-      return valid_position(grid, rotated_piece.translated(offset));
-    });
-    if (valid_offset != offsets.end()) {
-      falling_piece = rotated_piece.translated(*valid_offset);
-      lock_delay_frames = 0;
-      lock_delay_resets += 1;
-      last_move_rotation = true;
+    FallingPiece rotated_piece = falling_piece;
+    rotated_piece.orientation = rotation.orientation;
+    rotated_piece.map = rotation.map;
+    for (auto kick : rotation.kicks) {
+      const FallingPiece kicked_piece = rotated_piece.translated(kick);
+      if (grid.fits(kicked_piece)) {
+        falling_piece = kicked_piece;
+        lock_delay_frames = 0;
+        lock_delay_resets += 1;
+        last_move_rotation = true;
+        das_cut_frames = hand_set.dcd;
+        return;
+      }
     }
   };
 
-  if (ctrlr.clockwise())
+  if (inputs[Action::Clockwise])
     try_rotating(RotationType::Clockwise);
-  else if (ctrlr.counter_clockwise())
+  else if (inputs[Action::CounterClockwise])
     try_rotating(RotationType::CounterClockwise);
-  else if (ctrlr.one_eighty())
+  else if (inputs[Action::OneEighty])
     try_rotating(RotationType::OneEighty);
 }
 
-bool Playfield::handle_drops(const Ctrlr& ctrlr, const HandS& hand_set) {
-  if (ctrlr.check_hard_drop()) {
-    auto fallen = falling_piece.fallen();
-    while (valid_position(grid, fallen)) {
-      falling_piece = fallen;
-      fallen = falling_piece.fallen();
+bool Playfield::handle_drops(Inputs inputs, const HandS& hand_set) {
+  RAYTRIS_PROFILE_SCOPE("Playfield::handle_drops");
+  if (inputs[Action::HardDrop]) {
+    if (ghost_y() != falling_piece.y) {
+      falling_piece.y = ghost_y();
       last_move_rotation = false;
     }
     solidify_piece();
     return true;
   }
 
-  bool soft_fall = ctrlr.soft_drop() && frames_since_drop >= hand_set.soft_drop;
-  bool gravity_fall = frames_since_drop >= hand_set.gravity;
+  bool soft_fall =
+    inputs[Action::SoftDrop] && int(frames_since_drop) >= hand_set.soft_drop;
+  bool gravity_fall = int(frames_since_drop) >= hand_set.gravity;
   bool is_fall_step = soft_fall || gravity_fall;
   if (is_fall_step)
     frames_since_drop = 0;
 
-  bool can_fall = valid_position(grid, falling_piece.fallen());
-  bool can_wait = lock_delay_frames < hand_set.lock_delay_frames;
-  bool can_reset = lock_delay_resets < hand_set.lock_delay_resets;
+  bool can_fall = ghost_y() > falling_piece.y;
+  bool can_wait = int(lock_delay_frames) < hand_set.lock_delay_frames;
+  bool can_reset = int(lock_delay_resets) < hand_set.lock_delay_resets;
   if (!can_fall && (!can_wait || !can_reset)) {
     solidify_piece();
     return true;
   }
 
   if (can_fall && is_fall_step) {
+    // Soft drops move sdf rows a step, gravity always one
+    int rows = 1;
+    if (soft_fall) {
+      int room = ghost_y() - falling_piece.y;
+      rows = hand_set.sdf <= 0 ? room : std::min(hand_set.sdf, room);
+    }
     last_move_rotation = false;
-    falling_piece.fall();
+    falling_piece.y += rows;
     lock_delay_frames = 0;
     lock_delay_resets = 0;
   }
@@ -269,287 +517,25 @@ bool Playfield::handle_drops(const Ctrlr& ctrlr, const HandS& hand_set) {
   return false;
 }
 
-bool Playfield::update(const Ctrlr& ctrlr, const HandS& hand_set) {
+bool Playfield::update(Inputs inputs, const HandS& hand_set) {
+  RAYTRIS_PROFILE_SCOPE("Playfield::update");
+  sent_lines = 0;
   if (has_lost)
     return false;
 
-  handle_swap(ctrlr);
+  handle_swap(inputs);
+  if (has_lost)
+    return false;
 
   frames_since_drop += 1;
   lock_delay_frames += 1;
   if (message.timer > 0)
     message.timer -= 1;
 
-  handle_shifts(ctrlr, hand_set);
-  handle_rotations(ctrlr);
-  return handle_drops(ctrlr, hand_set);
-}
-
-namespace {
-constexpr Color tetromino_color(Tetromino tetromino) {
-  static constexpr std::array<Color, 8> colors = {
-    {{49, 199, 239, 255},
-     {247, 211, 8, 255},
-     {173, 77, 156, 255},
-     {239, 32, 41, 255},
-     {66, 182, 66, 255},
-     {90, 101, 173, 255},
-     {239, 121, 33, 255},
-     BLANK}
-  };
-  return colors.at(std::to_underlying(tetromino));
-}
-
-inline Rectangle get_block(int i, int j, const DrawD& draw_d) {
-  return {
-    draw_d.position.x + i * draw_d.block_length,
-    draw_d.position.y +
-      (j - static_cast<int>(Playfield::VISIBLE_HEIGHT)) * draw_d.block_length,
-    draw_d.block_length,
-    draw_d.block_length
-  };
-}
-
-void draw_block_pretty(int i, int j, const DrawD& draw_d, Color fill) {
-  if (fill.a == 0)
-    return;
-
-  Rectangle rec = get_block(i, j, draw_d);
-  DrawRectangleRec(rec, fill);
-  DrawRectangle(
-    rec.x + draw_d.block_length / 3,
-    rec.y + draw_d.block_length / 3,
-    rec.width / 3,
-    rec.height / 3,
-    DrawD::DEFAULT_PRETTY_OUTLINE
-  );
-  DrawRectangleLinesEx(
-    rec, draw_d.block_length / 8, DrawD::DEFAULT_PRETTY_OUTLINE
-  );
-}
-
-void draw_block_danger(int i, int j, const DrawD& draw_d) {
-  Rectangle rec = get_block(i, j, draw_d);
-  DrawRectangleLinesEx(rec, draw_d.block_length / 8, {255, 0, 0, 150});
-  DrawLineEx(
-    {rec.x + rec.width * 0.25f, rec.y + rec.height * 0.25f},
-    {rec.x + rec.width * 0.75f, rec.y + rec.height * 0.75f},
-    draw_d.block_length * 0.1f,
-    RED
-  );
-  DrawLineEx(
-    {rec.x + rec.width * 0.75f, rec.y + rec.height * 0.25f},
-    {rec.x + rec.width * 0.25f, rec.y + rec.height * 0.75f},
-    draw_d.block_length * 0.1f,
-    {255, 0, 0, 150}
-  );
-}
-
-void draw_piece(
-  const TetrominoMap& map,
-  Color color,
-  int x_offset,
-  int y_offset,
-  const DrawD& draw_d
-) {
-  for (auto coord : map) {
-    int x = coord.x + x_offset;
-    int y = coord.y + y_offset;
-    draw_block_pretty(x, y, draw_d, color);
-  }
-}
-
-void draw_piece_danger(Tetromino tetromino, const DrawD& draw_d) {
-  for (auto coord : initial_tetromino_map(tetromino)) {
-    int x = coord.x + INITIAL_X_POSITION;
-    int y = coord.y + INITIAL_Y_POSITION;
-    draw_block_danger(x, y, draw_d);
-  }
-}
-
-std::pair<const char*, Color> message_info(MessageType message) {
-  static constexpr std::array<std::pair<const char*, Color>, 6> info = {
-    {{"", BLANK},
-     {"SINGLE", {0, 0, 0, 255}},
-     {"DOUBLE", {235, 149, 52, 255}},
-     {"TRIPLE", {88, 235, 52, 255}},
-     {"TETRIS", {52, 164, 236, 255}},
-     {"ALL\nCLEAR", {235, 52, 213, 255}}}
-  };
-  return info.at(std::to_underlying(message));
-}
-}; // namespace
-
-void Playfield::draw_tetrion(const DrawD& draw_d) const {
-  Rectangle tetrion = Rectangle{
-    draw_d.position.x,
-    draw_d.position.y,
-    draw_d.block_length * WIDTH,
-    draw_d.block_length * VISIBLE_HEIGHT
-  };
-  DrawRectangleRec(tetrion, draw_d.TETRION_BACKGROUND_COLOR);
-  DrawRectangleLinesEx(
-    tetrion, draw_d.block_length / 10, draw_d.GRINDLINE_COLOR
-  );
-
-  for (int i = 1; i < WIDTH; ++i) {
-    Rectangle rec = get_block(i, VISIBLE_HEIGHT, draw_d);
-    rec.x = std::floor(rec.x);
-    rec.y = std::floor(rec.y);
-    DrawLineEx(
-      {rec.x, rec.y},
-      {rec.x, std::floor(rec.y + VISIBLE_HEIGHT * draw_d.block_length)},
-      draw_d.block_length / 10,
-      draw_d.GRINDLINE_COLOR
-    );
-  }
-
-  for (int j = 1; j < VISIBLE_HEIGHT; ++j) {
-    Rectangle rec = get_block(0, j + VISIBLE_HEIGHT, draw_d);
-    rec.x = std::floor(rec.x);
-    rec.y = std::floor(rec.y);
-    DrawLineEx(
-      {rec.x, rec.y},
-      {std::floor(rec.x + draw_d.block_length * WIDTH), rec.y},
-      draw_d.block_length / 10,
-      draw_d.GRINDLINE_COLOR
-    );
-  }
-
-  for (int j = 0; j < HEIGHT; ++j)
-    for (int i = 0; i < WIDTH; ++i)
-      draw_block_pretty(i, j, draw_d, tetromino_color(grid[j][i]));
-}
-
-void Playfield::draw_tetrion_pieces(const DrawD& draw_d) const {
-  FallingPiece ghost_piece = falling_piece;
-  while (valid_position(grid, ghost_piece.fallen()))
-    ghost_piece.fall();
-  draw_piece(ghost_piece.map, GRAY, ghost_piece.x, ghost_piece.y, draw_d);
-
-  draw_piece(
-    falling_piece.map,
-    tetromino_color(falling_piece.tetromino),
-    falling_piece.x,
-    falling_piece.y,
-    draw_d
-  );
-
-  static constexpr auto X_DANGER_RANGE = sv::iota(WIDTH / 2 - 2, WIDTH / 2 + 2);
-  static constexpr auto Y_DANGER_RANGE =
-    sv::iota(INITIAL_Y_POSITION, INITIAL_Y_POSITION + 5);
-  bool is_in_danger = sr::any_of(X_DANGER_RANGE, [this](auto x) {
-    return sr::any_of(Y_DANGER_RANGE, [this, x](auto y) {
-      return grid[y][x] != Tetromino::Empty;
-    });
-  });
-
-  if (is_in_danger)
-    draw_piece_danger(next_queue[0], draw_d);
-}
-
-void Playfield::draw_next_queue(const DrawD& draw_d) const {
-  Rectangle text_rect = get_block(WIDTH + 1, VISIBLE_HEIGHT, draw_d);
-  Rectangle background = get_block(WIDTH + 1, VISIBLE_HEIGHT + 2, draw_d);
-  background.width = draw_d.block_length * 6;
-  background.height = draw_d.block_length * (3 * (NextQueue::NEXT_SIZE) + 1);
-  DrawRectangleRec(background, draw_d.PIECES_BACKGROUND_COLOR);
-  DrawRectangleLinesEx(
-    background, draw_d.block_length / 4, draw_d.PIECE_BOX_COLOR
-  );
-  DrawText(
-    "NEXT", text_rect.x, text_rect.y, draw_d.font_size, draw_d.INFO_TEXT_COLOR
-  );
-  for (int id = 0; id < NextQueue::NEXT_SIZE; ++id)
-    draw_piece(
-      initial_tetromino_map(next_queue[id]),
-      tetromino_color(next_queue[id]),
-      WIDTH + 3,
-      3 * (id + 1) + VISIBLE_HEIGHT + 1,
-      draw_d
-    );
-}
-
-void Playfield::draw_hold_piece(const DrawD& draw_d) const {
-  Rectangle text_rect = get_block(-7, VISIBLE_HEIGHT, draw_d);
-  DrawText(
-    "HOLD", text_rect.x, text_rect.y, draw_d.font_size, draw_d.INFO_TEXT_COLOR
-  );
-  Rectangle background = get_block(-7, VISIBLE_HEIGHT + 2, draw_d);
-  background.width = draw_d.block_length * 6;
-  background.height = draw_d.block_length * 4;
-  DrawRectangleRec(background, draw_d.PIECES_BACKGROUND_COLOR);
-  DrawRectangleLinesEx(
-    background, draw_d.block_length / 4, draw_d.PIECE_BOX_COLOR
-  );
-
-  Color color = can_swap ? tetromino_color(holding_piece) :
-                           draw_d.UNAVAILABLE_HOLD_PIECE_COLOR;
-  draw_piece(
-    initial_tetromino_map(holding_piece), color, -5, 4 + VISIBLE_HEIGHT, draw_d
-  );
-}
-
-void Playfield::draw_info(const DrawD& draw_d) const {
-  if (message.timer > 0) {
-    Rectangle text_rect = get_block(draw_d.LEFT_BORDER, HEIGHT - 4, draw_d);
-    auto [msg, color] = message_info(message.message);
-    unsigned char alpha = (255.0 * message.timer) / LineClearMessage::DURATION;
-    color.a = alpha;
-    DrawText(msg, text_rect.x, text_rect.y, draw_d.font_size, color);
-
-    if (message.spin_type != SpinType::No) {
-      Color spin_color = tetromino_color(Tetromino::T);
-      spin_color.a = alpha;
-      Rectangle spin_rect = get_block(draw_d.LEFT_BORDER, HEIGHT - 6, draw_d);
-      DrawText("TSPIN", spin_rect.x, spin_rect.y, draw_d.font_size, spin_color);
-      if (message.spin_type == SpinType::Mini) {
-        Rectangle mini_rect = get_block(draw_d.LEFT_BORDER, HEIGHT - 7, draw_d);
-        DrawText(
-          "MINI", mini_rect.x, mini_rect.y, draw_d.font_size_small, spin_color
-        );
-      }
-    }
-  }
-
-  if (combo >= 2) {
-    Rectangle combo_rect = get_block(draw_d.LEFT_BORDER, HEIGHT - 10, draw_d);
-    DrawText("COMBO ", combo_rect.x, combo_rect.y, draw_d.font_size, BLUE);
-    DrawText(
-      std::format("{}", combo).c_str(),
-      combo_rect.x + MeasureText("COMBO ", draw_d.font_size),
-      combo_rect.y,
-      draw_d.font_size,
-      BLUE
-    );
-  }
-
-  if (b2b >= 2) {
-    Rectangle b2b_rect = get_block(draw_d.LEFT_BORDER, HEIGHT - 12, draw_d);
-    DrawText("B2B ", b2b_rect.x, b2b_rect.y, draw_d.font_size, BLUE);
-    DrawText(
-      std::format("{}", b2b - 1).c_str(),
-      b2b_rect.x + MeasureText("B2B ", draw_d.font_size),
-      b2b_rect.y,
-      draw_d.font_size,
-      BLUE
-    );
-  }
-
-  Rectangle score_rect = get_block(WIDTH + 1, HEIGHT - 2, draw_d);
-  DrawText(
-    std::format("{:09}", score).c_str(),
-    score_rect.x,
-    score_rect.y + draw_d.block_length * 0.5,
-    draw_d.font_size,
-    draw_d.INFO_TEXT_COLOR
-  );
-}
-
-void Playfield::draw(const DrawD& draw_d) const {
-  draw_tetrion(draw_d);
-  draw_tetrion_pieces(draw_d);
-  draw_next_queue(draw_d);
-  draw_hold_piece(draw_d);
-  draw_info(draw_d);
+  handle_shifts(inputs, hand_set);
+  handle_rotations(inputs, hand_set);
+  if (!handle_drops(inputs, hand_set))
+    return false;
+  das_cut_frames = hand_set.dcd;
+  return true;
 }
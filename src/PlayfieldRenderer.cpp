@@ -0,0 +1,324 @@
+#include "PlayfieldRenderer.hpp"
+#include "Profiler.hpp"
+#include "raylib.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using DrawD = DrawingDetails;
+
+static constexpr std::size_t WIDTH = Playfield::WIDTH;
+static constexpr std::size_t HEIGHT = Playfield::HEIGHT;
+static constexpr std::size_t VISIBLE_HEIGHT = Playfield::VISIBLE_HEIGHT;
+static constexpr std::size_t INITIAL_X_POSITION = Playfield::INITIAL_X_POSITION;
+static constexpr std::size_t INITIAL_Y_POSITION = Playfield::INITIAL_Y_POSITION;
+
+namespace {
+inline Rectangle get_block(int i, int j, const DrawD& draw_d) {
+  return {
+    draw_d.position.x + i * draw_d.block_length,
+    draw_d.position.y +
+      (j - static_cast<int>(VISIBLE_HEIGHT)) * draw_d.block_length,
+    draw_d.block_length,
+    draw_d.block_length
+  };
+}
+
+void draw_piece(
+  const MinoAtlas& atlas,
+  const TetrominoMap& map,
+  MinoStyle style,
+  int x_offset,
+  int y_offset,
+  const DrawD& draw_d
+) {
+  for (auto coord : map) {
+    Rectangle rec = get_block(coord.x + x_offset, coord.y + y_offset, draw_d);
+    atlas.draw(style, {rec.x, rec.y});
+  }
+}
+
+void draw_stack(const Grid& grid, const MinoAtlas& atlas, const DrawD& draw_d) {
+  Rectangle tetrion = Rectangle{
+    draw_d.position.x,
+    draw_d.position.y,
+    draw_d.block_length * WIDTH,
+    draw_d.block_length * VISIBLE_HEIGHT
+  };
+  DrawRectangleRec(tetrion, draw_d.TETRION_BACKGROUND_COLOR);
+  DrawRectangleLinesEx(
+    tetrion, draw_d.block_length / 10, draw_d.GRINDLINE_COLOR
+  );
+
+  for (int i = 1; i < WIDTH; ++i) {
+    Rectangle rec = get_block(i, VISIBLE_HEIGHT, draw_d);
+    rec.x = std::floor(rec.x);
+    rec.y = std::floor(rec.y);
+    DrawLineEx(
+      {rec.x, rec.y},
+      {rec.x, std::floor(rec.y + VISIBLE_HEIGHT * draw_d.block_length)},
+      draw_d.block_length / 10,
+      draw_d.GRINDLINE_COLOR
+    );
+  }
+
+  for (int j = 1; j < VISIBLE_HEIGHT; ++j) {
+    Rectangle rec = get_block(0, j + VISIBLE_HEIGHT, draw_d);
+    rec.x = std::floor(rec.x);
+    rec.y = std::floor(rec.y);
+    DrawLineEx(
+      {rec.x, rec.y},
+      {std::floor(rec.x + draw_d.block_length * WIDTH), rec.y},
+      draw_d.block_length / 10,
+      draw_d.GRINDLINE_COLOR
+    );
+  }
+
+  atlas.begin();
+  for (int j = 0; j < HEIGHT; ++j)
+    for (int i = 0; i < WIDTH; ++i) {
+      if (!grid.occupied(i, j))
+        continue;
+      Rectangle rec = get_block(i, j, draw_d);
+      Tetromino tetromino = grid.at(i, j);
+      MinoStyle style = tetromino == Tetromino::Empty ? MinoStyle::Garbage
+                                                      : mino_style(tetromino);
+      atlas.draw(style, {rec.x, rec.y});
+    }
+  atlas.end();
+}
+
+std::pair<const char*, Color> message_info(MessageType message) {
+  static constexpr std::array<std::pair<const char*, Color>, 6> info = {
+    {{"", BLANK},
+     {"SINGLE", {0, 0, 0, 255}},
+     {"DOUBLE", {235, 149, 52, 255}},
+     {"TRIPLE", {88, 235, 52, 255}},
+     {"TETRIS", {52, 164, 236, 255}},
+     {"ALL\nCLEAR", {235, 52, 213, 255}}}
+  };
+  return info.at(std::to_underlying(message));
+}
+}; // namespace
+
+// The texture spans the hidden rows too, locked cells can be drawn there
+PlayfieldRenderer::PlayfieldRenderer(const DrawD& _draw_d) :
+  draw_d(_draw_d),
+  atlas(draw_d.block_length),
+  stack_origin{
+    std::floor(draw_d.position.x),
+    std::floor(draw_d.position.y - VISIBLE_HEIGHT * draw_d.block_length)
+  } {
+  stack_texture = LoadRenderTexture(
+    std::ceil(WIDTH * draw_d.block_length) + 2,
+    std::ceil(HEIGHT * draw_d.block_length) + 2
+  );
+}
+
+PlayfieldRenderer::~PlayfieldRenderer() {
+  UnloadRenderTexture(stack_texture);
+}
+
+void PlayfieldRenderer::redraw_stack() const {
+  drawn_revision.reset();
+}
+
+void PlayfieldRenderer::draw_tetrion(const Playfield& playfield) const {
+  RAYTRIS_PROFILE_SCOPE("PlayfieldRenderer::draw_tetrion");
+  const Grid& grid = playfield.grid;
+  if (drawn_revision != grid.revision()) {
+    DrawD texture_draw_d(
+      draw_d.block_length,
+      {draw_d.position.x - stack_origin.x, draw_d.position.y - stack_origin.y}
+    );
+    BeginTextureMode(stack_texture);
+    ClearBackground(BLANK);
+    draw_stack(grid, atlas, texture_draw_d);
+    EndTextureMode();
+    drawn_revision = grid.revision();
+  }
+
+  // Render textures are stored upside down
+  const Texture2D& texture = stack_texture.texture;
+  Rectangle source{0, 0, float(texture.width), -float(texture.height)};
+  DrawTextureRec(texture, source, stack_origin, WHITE);
+}
+
+void PlayfieldRenderer::draw_next_queue() const {
+  RAYTRIS_PROFILE_SCOPE("PlayfieldRenderer::draw_next_queue");
+  Rectangle text_rect = get_block(WIDTH + 1, VISIBLE_HEIGHT, draw_d);
+  Rectangle background = get_block(WIDTH + 1, VISIBLE_HEIGHT + 2, draw_d);
+  background.width = draw_d.block_length * 6;
+  background.height = draw_d.block_length * (3 * (NextQueue::NEXT_SIZE) + 1);
+  DrawRectangleRec(background, draw_d.PIECES_BACKGROUND_COLOR);
+  DrawRectangleLinesEx(
+    background, draw_d.block_length / 4, draw_d.PIECE_BOX_COLOR
+  );
+  DrawText(
+    "NEXT", text_rect.x, text_rect.y, draw_d.font_size, draw_d.INFO_TEXT_COLOR
+  );
+}
+
+void PlayfieldRenderer::draw_hold_piece() const {
+  RAYTRIS_PROFILE_SCOPE("PlayfieldRenderer::draw_hold_piece");
+  Rectangle text_rect = get_block(-7, VISIBLE_HEIGHT, draw_d);
+  DrawText(
+    "HOLD", text_rect.x, text_rect.y, draw_d.font_size, draw_d.INFO_TEXT_COLOR
+  );
+  Rectangle background = get_block(-7, VISIBLE_HEIGHT + 2, draw_d);
+  background.width = draw_d.block_length * 6;
+  background.height = draw_d.block_length * 4;
+  DrawRectangleRec(background, draw_d.PIECES_BACKGROUND_COLOR);
+  DrawRectangleLinesEx(
+    background, draw_d.block_length / 4, draw_d.PIECE_BOX_COLOR
+  );
+}
+
+// A bar along the left wall as tall as the lines waiting to rise
+void PlayfieldRenderer::draw_incoming_garbage(
+  const Playfield& playfield
+) const {
+  RAYTRIS_PROFILE_SCOPE("PlayfieldRenderer::draw_incoming_garbage");
+  auto lines = std::min<std::size_t>(
+    playfield.incoming_garbage().lines(), VISIBLE_HEIGHT
+  );
+  if (lines == 0)
+    return;
+  Rectangle bottom = get_block(-1, HEIGHT - 1, draw_d);
+  Rectangle meter{
+    bottom.x + draw_d.block_length * 0.5f,
+    bottom.y + draw_d.block_length * (1.0f - lines),
+    draw_d.block_length * 0.4f,
+    draw_d.block_length * lines
+  };
+  DrawRectangleRec(meter, draw_d.INCOMING_GARBAGE_COLOR);
+}
+
+// Every mino but the locked ones, in one batch from the atlas
+void PlayfieldRenderer::draw_minos(const Playfield& playfield) const {
+  RAYTRIS_PROFILE_SCOPE("PlayfieldRenderer::draw_minos");
+  atlas.begin();
+  const FallingPiece& falling_piece = playfield.falling_piece;
+  draw_piece(
+    atlas,
+    falling_piece.map,
+    MinoStyle::Ghost,
+    falling_piece.x,
+    playfield.ghost_y(),
+    draw_d
+  );
+  draw_piece(
+    atlas,
+    falling_piece.map,
+    mino_style(falling_piece.tetromino),
+    falling_piece.x,
+    falling_piece.y,
+    draw_d
+  );
+
+  const NextQueue& next_queue = playfield.next_queue;
+  if (playfield.in_danger())
+    draw_piece(
+      atlas,
+      initial_tetromino_map(next_queue[0]),
+      MinoStyle::Danger,
+      INITIAL_X_POSITION,
+      INITIAL_Y_POSITION,
+      draw_d
+    );
+
+  for (int id = 0; id < NextQueue::NEXT_SIZE; ++id)
+    draw_piece(
+      atlas,
+      initial_tetromino_map(next_queue[id]),
+      mino_style(next_queue[id]),
+      WIDTH + 3,
+      3 * (id + 1) + VISIBLE_HEIGHT + 1,
+      draw_d
+    );
+
+  Tetromino holding_piece = playfield.holding_piece;
+  if (holding_piece != Tetromino::Empty)
+    draw_piece(
+      atlas,
+      initial_tetromino_map(holding_piece),
+      playfield.can_swap ? mino_style(holding_piece) : MinoStyle::Unavailable,
+      -5,
+      4 + VISIBLE_HEIGHT,
+      draw_d
+    );
+  atlas.end();
+}
+
+void PlayfieldRenderer::draw_info(const Playfield& playfield) const {
+  RAYTRIS_PROFILE_SCOPE("PlayfieldRenderer::draw_info");
+  const LineClearMessage& message = playfield.message;
+  if (message.timer > 0) {
+    Rectangle text_rect = get_block(draw_d.LEFT_BORDER, HEIGHT - 4, draw_d);
+    auto [msg, color] = message_info(message.message);
+    unsigned char alpha = (255.0 * message.timer) / LineClearMessage::DURATION;
+    color.a = alpha;
+    DrawText(msg, text_rect.x, text_rect.y, draw_d.font_size, color);
+
+    if (message.spin_type != SpinType::No) {
+      Color spin_color =
+        DrawD::TETROMINO_COLORS[std::to_underlying(Tetromino::T)];
+      spin_color.a = alpha;
+      Rectangle spin_rect = get_block(draw_d.LEFT_BORDER, HEIGHT - 6, draw_d);
+      DrawText("TSPIN", spin_rect.x, spin_rect.y, draw_d.font_size, spin_color);
+      if (message.spin_type == SpinType::Mini) {
+        Rectangle mini_rect = get_block(draw_d.LEFT_BORDER, HEIGHT - 7, draw_d);
+        DrawText(
+          "MINI", mini_rect.x, mini_rect.y, draw_d.font_size_small, spin_color
+        );
+      }
+    }
+  }
+
+  if (playfield.combo >= 2) {
+    Rectangle combo_rect = get_block(draw_d.LEFT_BORDER, HEIGHT - 10, draw_d);
+    DrawText(
+      combo_label.c_str(), combo_rect.x, combo_rect.y, draw_d.font_size, BLUE
+    );
+    DrawText(
+      combo_text.c_str(playfield.combo),
+      combo_rect.x + combo_label.width(draw_d.font_size),
+      combo_rect.y,
+      draw_d.font_size,
+      BLUE
+    );
+  }
+
+  if (playfield.b2b >= 2) {
+    Rectangle b2b_rect = get_block(draw_d.LEFT_BORDER, HEIGHT - 12, draw_d);
+    DrawText(
+      b2b_label.c_str(), b2b_rect.x, b2b_rect.y, draw_d.font_size, BLUE
+    );
+    DrawText(
+      b2b_text.c_str(playfield.b2b - 1),
+      b2b_rect.x + b2b_label.width(draw_d.font_size),
+      b2b_rect.y,
+      draw_d.font_size,
+      BLUE
+    );
+  }
+
+  Rectangle score_rect = get_block(WIDTH + 1, HEIGHT - 2, draw_d);
+  DrawText(
+    score_text.c_str(playfield.score),
+    score_rect.x,
+    score_rect.y + draw_d.block_length * 0.5,
+    draw_d.font_size,
+    draw_d.INFO_TEXT_COLOR
+  );
+}
+
+void PlayfieldRenderer::draw(const Playfield& playfield) const {
+  RAYTRIS_PROFILE_SCOPE("PlayfieldRenderer::draw");
+  draw_tetrion(playfield);
+  draw_next_queue();
+  draw_hold_piece();
+  draw_info(playfield);
+  draw_incoming_garbage(playfield);
+  draw_minos(playfield);
+}
@@ -0,0 +1,188 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <ostream>
+#include <string_view>
+
+namespace {
+// Writers claim a slot with a single increment. Every slot carries the index
+// it was last written for, which a reader checks before and after copying it
+// out, so slots being rewritten are skipped instead of read torn.
+class EventRing {
+  static constexpr std::size_t CAPACITY = 1 << 16;
+  static constexpr std::uint64_t WRITING = ~std::uint64_t{0};
+
+  struct Slot {
+    std::atomic<std::uint64_t> index{WRITING};
+    std::atomic<const char*> name;
+    std::atomic<std::uint64_t> begin_ns;
+    std::atomic<std::uint64_t> end_ns;
+    std::atomic<std::uint32_t> thread;
+  };
+
+  std::array<Slot, CAPACITY> slots;
+  std::atomic<std::uint64_t> next_index{0};
+
+public:
+  void push(const profiler::Event& event) {
+    auto index = next_index.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[index % CAPACITY];
+    slot.index.store(WRITING, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(event.name, std::memory_order_relaxed);
+    slot.begin_ns.store(event.begin_ns, std::memory_order_relaxed);
+    slot.end_ns.store(event.end_ns, std::memory_order_relaxed);
+    slot.thread.store(event.thread, std::memory_order_relaxed);
+    slot.index.store(index, std::memory_order_release);
+  }
+
+  std::vector<profiler::Event> snapshot() const {
+    auto end = next_index.load(std::memory_order_acquire);
+    auto begin = end > CAPACITY ? end - CAPACITY : 0;
+    std::vector<profiler::Event> events;
+    events.reserve(end - begin);
+    for (auto index = begin; index < end; index++) {
+      const Slot& slot = slots[index % CAPACITY];
+      if (slot.index.load(std::memory_order_acquire) != index)
+        continue;
+      profiler::Event event{
+        slot.name.load(std::memory_order_relaxed),
+        slot.begin_ns.load(std::memory_order_relaxed),
+        slot.end_ns.load(std::memory_order_relaxed),
+        slot.thread.load(std::memory_order_relaxed),
+      };
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.index.load(std::memory_order_relaxed) == index)
+        events.push_back(event);
+    }
+    return events;
+  }
+};
+
+EventRing ring;
+std::atomic<std::uint32_t> thread_count{0};
+// Per thread, so counting never contends and the game loop's counts are not
+// mixed up with the bot's or the thread pool's
+thread_local profiler::HeapStats heap{};
+}; // namespace
+
+// Every other unaligned form forwards to these two, so all of them are
+// counted. Only the aligned forms go to the standard library uncounted.
+void* operator new(std::size_t size) {
+  heap.allocations++;
+  heap.bytes += size;
+  if (void* memory = std::malloc(size == 0 ? 1 : size))
+    return memory;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+  heap.frees += memory != nullptr;
+  std::free(memory);
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return ::operator new(size);
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return ::operator new(size, std::nothrow);
+}
+
+void operator delete[](void* memory) noexcept { ::operator delete(memory); }
+
+void operator delete(void* memory, std::size_t) noexcept {
+  ::operator delete(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+  ::operator delete(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+  ::operator delete(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+  ::operator delete(memory);
+}
+
+namespace profiler {
+std::uint64_t now_ns() {
+  auto since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch)
+    .count();
+}
+
+std::uint32_t thread_index() {
+  thread_local const std::uint32_t index = thread_count.fetch_add(1);
+  return index;
+}
+
+void record(const Event& event) {
+  ring.push(event);
+}
+
+std::vector<Event> events() {
+  return ring.snapshot();
+}
+
+std::vector<ScopeStats> summarize() {
+  auto events = ring.snapshot();
+  auto duration = [](const Event& event) {
+    return event.end_ns - event.begin_ns;
+  };
+  std::ranges::sort(events, [&](const Event& a, const Event& b) {
+    std::string_view a_name = a.name, b_name = b.name;
+    return a_name != b_name ? a_name < b_name : duration(a) < duration(b);
+  });
+
+  std::vector<ScopeStats> stats;
+  for (auto first = events.begin(); first != events.end();) {
+    auto last = std::find_if(first, events.end(), [&](const Event& event) {
+      return std::string_view(event.name) != first->name;
+    });
+    std::size_t count = last - first;
+    stats.push_back({
+      first->name,
+      count,
+      duration(first[count / 2]),
+      duration(first[count * 99 / 100]),
+    });
+    first = last;
+  }
+  return stats;
+}
+
+void write_chrome_trace(std::ostream& out) {
+  auto events = ring.snapshot();
+  auto start = events.empty() ? 0 : events.front().begin_ns;
+  for (const Event& event : events)
+    start = std::min(start, event.begin_ns);
+
+  out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  for (std::size_t i = 0; i < events.size(); i++) {
+    const Event& event = events[i];
+    out << (i == 0 ? "\n" : ",\n") << "{\"name\":\"" << event.name
+        << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+        << ",\"ts\":" << (event.begin_ns - start) / 1000.0
+        << ",\"dur\":" << (event.end_ns - event.begin_ns) / 1000.0 << "}";
+  }
+  out << "\n]}\n";
+}
+
+HeapStats heap_stats() {
+  return heap;
+}
+} // namespace profiler
@@ -0,0 +1,63 @@
+#include "ProfilerOverlay.hpp"
+#include "Profiler.hpp"
+#include "raylib.h"
+#include <format>
+#include <fstream>
+
+namespace {
+void format_micros(std::array<char, 16>& text, std::uint64_t ns) {
+  auto end =
+    std::format_to_n(text.data(), text.size() - 1, "{:.1f}", ns / 1e3);
+  *end.out = '\0';
+}
+}; // namespace
+
+void ProfilerOverlay::update() {
+  if (IsKeyPressed(KEY_F3))
+    visible = !visible;
+  if (IsKeyPressed(KEY_F4)) {
+    std::ofstream out("profile.json");
+    profiler::write_chrome_trace(out);
+  }
+
+  if (!visible || frames_since_refresh++ % REFRESH_FRAMES != 0)
+    return;
+  auto heap = profiler::heap_stats();
+  auto end = std::format_to_n(
+    heap_line.data(),
+    heap_line.size() - 1,
+    "{} heap allocations in {} frames",
+    heap.allocations - allocations,
+    REFRESH_FRAMES
+  );
+  *end.out = '\0';
+  lines.clear();
+  for (const auto& stats : profiler::summarize()) {
+    Line& line = lines.emplace_back(stats.name);
+    format_micros(line.p50, stats.p50_ns);
+    format_micros(line.p99, stats.p99_ns);
+  }
+  allocations = profiler::heap_stats().allocations;
+}
+
+void ProfilerOverlay::draw() const {
+  if (!visible)
+    return;
+
+  static constexpr int FONT_SIZE = 20;
+  static constexpr int NAME_X = 10;
+  static constexpr int P50_X = 360;
+  static constexpr int P99_X = 460;
+  DrawRectangle(0, 0, 560, FONT_SIZE * (lines.size() + 3), {0, 0, 0, 180});
+  DrawText("scope", NAME_X, 5, FONT_SIZE, WHITE);
+  DrawText("p50 us", P50_X, 5, FONT_SIZE, WHITE);
+  DrawText("p99 us", P99_X, 5, FONT_SIZE, WHITE);
+  for (int i = 0; i < int(lines.size()); i++) {
+    int y = 5 + FONT_SIZE * (i + 1);
+    DrawText(lines[i].name, NAME_X, y, FONT_SIZE, WHITE);
+    DrawText(lines[i].p50.data(), P50_X, y, FONT_SIZE, WHITE);
+    DrawText(lines[i].p99.data(), P99_X, y, FONT_SIZE, WHITE);
+  }
+  int y = 5 + FONT_SIZE * (lines.size() + 1);
+  DrawText(heap_line.data(), NAME_X, y, FONT_SIZE, WHITE);
+}
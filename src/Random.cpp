@@ -0,0 +1,52 @@
+#include "Random.hpp"
+#include "Serialization.hpp"
+#include <random>
+
+static constexpr std::uint64_t MULTIPLIER = 6364136223846793005u;
+
+Pcg32::Pcg32(std::uint64_t seed, std::uint64_t stream) :
+  state(0),
+  increment((stream << 1) | 1) {
+  (*this)();
+  state += seed;
+  (*this)();
+}
+
+std::uint32_t Pcg32::operator()() {
+  std::uint64_t old_state = state;
+  state = old_state * MULTIPLIER + increment;
+  auto xorshifted =
+    static_cast<std::uint32_t>(((old_state >> 18) ^ old_state) >> 27);
+  auto rotation = static_cast<std::uint32_t>(old_state >> 59);
+  return (xorshifted >> rotation) | (xorshifted << ((-rotation) & 31));
+}
+
+std::uint32_t Pcg32::bounded(std::uint32_t bound) {
+  // Reject the low values that would make the modulo biased
+  std::uint32_t threshold = -bound % bound;
+  for (;;)
+    if (std::uint32_t value = (*this)(); value >= threshold)
+      return value % bound;
+}
+
+std::uint64_t Pcg32::next_seed() {
+  std::uint64_t high = (*this)();
+  return (high << 32) | (*this)();
+}
+
+void Pcg32::save(BitWriter& writer) const {
+  writer.write(state, 64);
+  writer.write(increment, 64);
+}
+
+void Pcg32::load(BitReader& reader) {
+  state = reader.read(64);
+  increment = reader.read(64);
+  if (increment % 2 == 0)
+    reader.fail();
+}
+
+std::uint64_t random_seed() {
+  std::random_device device;
+  return (std::uint64_t{device()} << 32) | device();
+}
@@ -1,5 +1,8 @@
 #include "Raytris.hpp"
+#include "Profiler.hpp"
 #include "SettingsMenu.hpp"
+#include <algorithm>
+#include <chrono>
 #include <raylib.h>
 #if defined(PLATFORM_WEB)
 #include <emscripten/emscripten.h>
@@ -13,16 +16,19 @@ Raytris::Raytris() {
   if (resolution == Resolution::FullScreen)
     ToggleFullscreen();
 #endif
+  set_render_mode(SettingsMenu::config().render_mode);
+  key_capture.emplace(key_events);
 }
 
 Raytris::~Raytris() {
+  key_capture.reset();
   CloseWindow();
 }
 
 void Raytris::handle_stop_runnig(auto&& runnable) {
   using T = std::decay_t<decltype(runnable)>;
   if constexpr (std::is_same_v<T, MainMenu>) {
-    auto&& handling_settings = SettingsMenu::config().handling_settings;
+    auto handling_settings = SettingsMenu::config().handling_settings;
     switch (runnable.get_selected_option()) {
     case MainMenu::Option::Exit:
       should_stop_running = true;
@@ -33,39 +39,125 @@ void Raytris::handle_stop_runnig(auto&& runnable) {
     case MainMenu::Option::TwoPlayers:
       raytris.emplace<TwoPlayerGame>(handling_settings, handling_settings);
       break;
+    case MainMenu::Option::VersusCpu:
+      raytris.emplace<TwoPlayerGame>(
+        handling_settings, handling_settings, TwoPlayerGame::CPU
+      );
+      break;
+    case MainMenu::Option::Replay:
+      raytris.emplace<ReplayGame>("replay.raytris");
+      break;
     case MainMenu::Option::Settings:
       raytris.emplace<SettingsMenu>();
       break;
     }
   } else {
     raytris.emplace<MainMenu>();
+    // The settings menu saved its config when it was destroyed above
+    if constexpr (std::is_same_v<T, SettingsMenu>)
+      set_render_mode(SettingsMenu::config().render_mode);
   }
 }
 
-void Raytris::run() {
-  static constexpr auto update_draw = [](Raytris* self) {
-    std::visit(
-      [self](auto&& app) {
+void Raytris::set_render_mode(RenderMode mode) {
+#if defined(PLATFORM_WEB)
+  // The browser draws on its own refresh, whatever the setting says
+  render_mode = RenderMode::VSync;
+#else
+  render_mode = mode;
+  if (mode == RenderMode::VSync)
+    SetWindowState(FLAG_VSYNC_HINT);
+  else
+    ClearWindowState(FLAG_VSYNC_HINT);
+#endif
+}
+
+void Raytris::frame() {
+  key_capture->sample();
+  const auto now = FixedTimestep::Clock::now();
+  const int ticks = timestep.advance(now);
+  std::visit(
+    [this, now, ticks](auto&& app) {
+      RAYTRIS_PROFILE_SCOPE("Raytris::update");
+      // Games step once per tick on the key events that came before it,
+      // menus simply follow the frames and read raylib's key state
+      if constexpr (requires { app.update(tick_events); }) {
+        for (int tick = 0; tick < ticks; tick++) {
+          // Ticks caught up on are spread back over the time they missed
+          auto until = now - FixedTimestep::TICK * (ticks - 1 - tick);
+          tick_events.clear();
+          while (auto event = key_events.front()) {
+            if (event->time > until)
+              break;
+            tick_events.push_back(*event);
+            key_events.pop();
+          }
+          app.update(tick_events);
+        }
+      } else {
+        key_events.clear();
         app.update();
-        if (app.should_stop_running())
-          self->handle_stop_runnig(app);
-        BeginDrawing();
-        ClearBackground(DrawingDetails::BACKGROUND_COLOR);
-        app.draw();
-        EndDrawing();
-      },
-      self->raytris
-    );
-  };
+      }
+      if (app.should_stop_running())
+        handle_stop_runnig(app);
+    },
+    raytris
+  );
+
+  if (render_mode == RenderMode::TickRate && ticks == 0) {
+    // Nothing moved, sleep until the next tick and poll the input that came
+    // in meanwhile, which EndDrawing() would have done
+    auto wait = timestep.next_tick() - FixedTimestep::Clock::now();
+    WaitTime(std::max(std::chrono::duration<double>(wait).count(), 0.0));
+    PollInputEvents();
+    return;
+  }
 
+  {
+    RAYTRIS_PROFILE_SCOPE("Raytris::draw");
+    BeginDrawing();
+    ClearBackground(DrawingDetails::BACKGROUND_COLOR);
+    std::visit([](const auto& app) { app.draw(); }, raytris);
+  }
+#ifdef RAYTRIS_PROFILE
+  profiler_overlay.update();
+  profiler_overlay.draw();
+#endif
+  RAYTRIS_PROFILE_SCOPE("Raytris::present");
+  EndDrawing();
+  if (render_mode == RenderMode::VSync)
+    cap_frame_rate();
+}
+
+void Raytris::cap_frame_rate() {
+#if !defined(PLATFORM_WEB)
+  // With vsync honored EndDrawing() already blocked for the rest of the
+  // refresh and this waits for nothing. The slack keeps a frame that came
+  // back a little early from being pushed past the next vblank.
+  int refresh_rate = GetMonitorRefreshRate(GetCurrentMonitor());
+  if (refresh_rate <= 0)
+    refresh_rate = FixedTimestep::TICK_RATE;
+  const std::chrono::duration<double> period(0.95 / refresh_rate);
+  auto wait = last_present + period - FixedTimestep::Clock::now();
+  if (wait > wait.zero()) {
+    WaitTime(std::chrono::duration<double>(wait).count());
+    PollInputEvents();
+  }
+  last_present = FixedTimestep::Clock::now();
+#endif
+}
+
+void Raytris::run() {
 #if defined(PLATFORM_WEB)
   emscripten_set_main_loop_arg(
-    [](void* p) -> void { update_draw((Raytris*)p); }, (void*)this, 0, true
+    [](void* p) -> void { ((Raytris*)p)->frame(); }, (void*)this, 0, true
   );
 #else
-  SetTargetFPS(60);
+  // Frames are paced by vsync, capped near the refresh rate in case the
+  // driver ignores it, or by waiting for ticks. The simulation keeps its own
+  // clock either way
   while (!should_stop_running) {
-    update_draw(this);
+    frame();
   }
 #endif
 }
@@ -0,0 +1,212 @@
+#include "Replay.hpp"
+#include <utility>
+
+namespace {
+// Menu and history actions are handled outside Playfield::update
+constexpr std::uint16_t RECORDED_ACTIONS = [] {
+  Inputs inputs;
+  for (Action action :
+       {Action::Swap,
+        Action::Left,
+        Action::Right,
+        Action::LeftDas,
+        Action::RightDas,
+        Action::Clockwise,
+        Action::CounterClockwise,
+        Action::OneEighty,
+        Action::HardDrop,
+        Action::SoftDrop})
+    inputs.set(action);
+  return inputs.mask();
+}();
+
+std::uint32_t digest(const Playfield& playfield) {
+  BitWriter writer;
+  playfield.save(writer);
+  std::uint32_t hash = 2166136261u;
+  for (std::uint8_t byte : writer.data()) {
+    hash ^= byte;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+}; // namespace
+
+ReplaySummary summarize(
+  const Playfield& playfield, std::uint64_t frames, std::uint64_t locks
+) {
+  return {
+    frames, locks, playfield.get_score(), playfield.lost(), digest(playfield)
+  };
+}
+
+ReplayWriter::ReplayWriter(
+  std::string _path, const HandlingSettings& _settings
+) :
+  path(std::move(_path)),
+  settings(_settings) {}
+
+ReplayWriter::~ReplayWriter() {
+  if (!out.is_open())
+    return;
+  end_run();
+  flush_chunk();
+}
+
+void ReplayWriter::begin(const Playfield& playfield) {
+  out.close();
+  out.open(path, std::ios::binary | std::ios::trunc);
+  save_file::write_header(out);
+  writer.clear();
+  settings.save(writer);
+  playfield.save(writer);
+  save_file::write_record(out, save_file::RecordKind::ReplayStart, writer);
+  chunk_runs = 0;
+  run_length = 0;
+  frames = 0;
+  locks = 0;
+}
+
+void ReplayWriter::record(Inputs inputs, bool locked) {
+  if (!out.is_open())
+    return;
+  inputs = Inputs(inputs.mask() & RECORDED_ACTIONS);
+  if (run_length == 0 || inputs != run_inputs) {
+    end_run();
+    run_inputs = inputs;
+  }
+  run_length += 1;
+  frames += 1;
+  locks += locked;
+}
+
+void ReplayWriter::end_run() {
+  if (run_length == 0)
+    return;
+  runs[chunk_runs++] = {run_inputs, run_length};
+  run_length = 0;
+  if (chunk_runs == RUNS_PER_CHUNK)
+    flush_chunk();
+}
+
+void ReplayWriter::flush_chunk() {
+  if (chunk_runs == 0)
+    return;
+  writer.clear();
+  writer.write_varint(chunk_runs);
+  for (auto [inputs, length] : std::span(runs.data(), chunk_runs)) {
+    writer.write(inputs.mask(), Inputs::BITS);
+    writer.write_varint(length);
+  }
+  save_file::write_record(out, save_file::RecordKind::ReplayInputs, writer);
+  out.flush();
+  chunk_runs = 0;
+}
+
+void ReplayWriter::finish(const Playfield& playfield) {
+  if (!out.is_open())
+    return;
+  end_run();
+  flush_chunk();
+  ReplaySummary summary = summarize(playfield, frames, locks);
+  writer.clear();
+  writer.write_varint(summary.frames);
+  writer.write_varint(summary.locks);
+  writer.write(summary.score, 64);
+  writer.write_bool(summary.lost);
+  writer.write(summary.digest, 32);
+  save_file::write_record(out, save_file::RecordKind::ReplayEnd, writer);
+  out.close();
+}
+
+ReplayReader::ReplayReader(const std::string& path) :
+  in(path, std::ios::binary),
+  chunk_reader(chunk.payload) {
+  if (!in.good() || save_file::read_header(in) != save_file::VERSION)
+    return;
+  auto record = save_file::read_record(in);
+  if (!record || record->kind != save_file::RecordKind::ReplayStart)
+    return;
+  BitReader reader(record->payload);
+  settings.load(reader, save_file::VERSION);
+  start.load(reader);
+  valid = reader.good();
+}
+
+bool ReplayReader::good() const {
+  return valid;
+}
+
+const HandlingSettings& ReplayReader::handling_settings() const {
+  return settings;
+}
+
+const Playfield& ReplayReader::starting_playfield() const {
+  return start;
+}
+
+bool ReplayReader::next_chunk() {
+  if (!save_file::read_record(in, chunk))
+    return false;
+
+  chunk_reader = BitReader(chunk.payload);
+  if (chunk.kind == save_file::RecordKind::ReplayInputs) {
+    chunk_runs = chunk_reader.read_varint();
+    return chunk_reader.good();
+  }
+  if (chunk.kind == save_file::RecordKind::ReplayEnd) {
+    ReplaySummary summary;
+    summary.frames = chunk_reader.read_varint();
+    summary.locks = chunk_reader.read_varint();
+    summary.score = chunk_reader.read(64);
+    summary.lost = chunk_reader.read_bool();
+    summary.digest = chunk_reader.read(32);
+    if (chunk_reader.good())
+      end = summary;
+  }
+  return false;
+}
+
+std::optional<Inputs> ReplayReader::next() {
+  if (!valid)
+    return std::nullopt;
+  while (run_length == 0) {
+    if (chunk_runs == 0 && !next_chunk())
+      return std::nullopt;
+    run_inputs = Inputs(chunk_reader.read(Inputs::BITS));
+    run_length = chunk_reader.read_varint();
+    chunk_runs -= 1;
+    if (!chunk_reader.good())
+      return std::nullopt;
+  }
+  run_length -= 1;
+  return run_inputs;
+}
+
+const std::optional<ReplaySummary>& ReplayReader::summary() const {
+  return end;
+}
+
+ReplayResult verify_replay(const std::string& path, ReplaySummary* result) {
+  ReplayReader reader(path);
+  if (!reader.good())
+    return ReplayResult::Invalid;
+
+  Playfield playfield = reader.starting_playfield();
+  const HandlingSettings& settings = reader.handling_settings();
+  std::uint64_t frames = 0;
+  std::uint64_t locks = 0;
+  while (auto inputs = reader.next()) {
+    locks += playfield.update(*inputs, settings);
+    frames += 1;
+  }
+
+  ReplaySummary summary = summarize(playfield, frames, locks);
+  if (result)
+    *result = summary;
+  if (!reader.summary())
+    return ReplayResult::Truncated;
+  if (*reader.summary() != summary)
+    return ReplayResult::Mismatch;
+  return ReplayResult::Verified;
+}
@@ -0,0 +1,75 @@
+#include "ReplayGame.hpp"
+
+static DrawingDetails makeDrawingDetails() {
+  float blockLength = DrawingDetails::HEIGHT_SCALE_FACTOR * GetScreenHeight() /
+    Playfield::VISIBLE_HEIGHT;
+  Vector2 position{
+    (GetScreenWidth() - blockLength * Playfield::WIDTH) / 2.0f,
+    (GetScreenHeight() - blockLength * Playfield::VISIBLE_HEIGHT) / 2.0f
+  };
+  return {blockLength, position};
+};
+
+ReplayGame::ReplayGame(const std::string& path) :
+  drawing_details(makeDrawingDetails()),
+  renderer(drawing_details),
+  reader(path),
+  playfield(reader.starting_playfield()),
+  finished(!reader.good()) {}
+
+void ReplayGame::step() {
+  if (auto inputs = reader.next())
+    playfield.update(*inputs, reader.handling_settings());
+  else
+    finished = true;
+}
+
+void ReplayGame::update(std::span<const KeyEvent> events) {
+  for (const KeyEvent& event : events) {
+    if (event.key == KEY_ENTER && event.down)
+      paused = !paused;
+    if (event.key == KEY_RIGHT)
+      fast_forward = event.down;
+  }
+  if (paused)
+    return;
+
+  int frames = fast_forward ? FAST_FORWARD_FRAMES : 1;
+  for (int frame = 0; frame < frames && !finished; frame++)
+    step();
+}
+
+void ReplayGame::draw() const {
+  if (reader.good())
+    renderer.draw(playfield);
+
+  if (!finished && !paused)
+    return;
+
+  const float width = GetScreenWidth();
+  const float height = GetScreenHeight();
+  DrawRectangle(0, 0, width, height, DrawingDetails::DARKEN_COLOR);
+
+  const char* title = !reader.good() ? "NO REPLAY"
+    : finished                       ? "REPLAY OVER"
+                                     : "REPLAY PAUSED";
+  DrawText(
+    title,
+    (width - MeasureText(title, drawing_details.font_size_big)) / 2.0,
+    height / 2.0,
+    drawing_details.font_size_big,
+    drawing_details.GAME_PAUSED_COLOR
+  );
+  DrawText(
+    "Press Esc to quit",
+    (width - MeasureText("Press Esc to quit", drawing_details.font_size)) /
+      2.0,
+    height / 2.0 + drawing_details.font_size_big,
+    drawing_details.font_size,
+    drawing_details.QUIT_COLOR
+  );
+}
+
+bool ReplayGame::should_stop_running() const {
+  return IsKeyPressed(KEY_ESCAPE);
+}
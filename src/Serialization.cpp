@@ -0,0 +1,173 @@
+#include "Serialization.hpp"
+#include <istream>
+#include <ostream>
+
+void BitWriter::write(std::uint64_t value, unsigned int bits) {
+  for (unsigned int bit = 0; bit < bits; bit++, bit_count++) {
+    if (bit_count % 8 == 0)
+      bytes.push_back(0);
+    if ((value >> bit) & 1)
+      bytes.back() |= 1 << (bit_count % 8);
+  }
+}
+
+void BitWriter::write_bool(bool value) {
+  write(value, 1);
+}
+
+void BitWriter::write_signed(std::int64_t value, unsigned int bits) {
+  write(static_cast<std::uint64_t>(value), bits);
+}
+
+void BitWriter::write_varint(std::uint64_t value) {
+  do {
+    write(value & 0x7F, 7);
+    value >>= 7;
+    write_bool(value != 0);
+  } while (value != 0);
+}
+
+std::span<const std::uint8_t> BitWriter::data() const {
+  return bytes;
+}
+
+void BitWriter::clear() {
+  bytes.clear();
+  bit_count = 0;
+}
+
+BitReader::BitReader(std::span<const std::uint8_t> _bytes) : bytes(_bytes) {}
+
+std::uint64_t BitReader::read(unsigned int bits) {
+  if (failed || bit_position + bits > bytes.size() * 8) {
+    failed = true;
+    return 0;
+  }
+  std::uint64_t value = 0;
+  for (unsigned int bit = 0; bit < bits; bit++, bit_position++)
+    if ((bytes[bit_position / 8] >> (bit_position % 8)) & 1)
+      value |= std::uint64_t{1} << bit;
+  return value;
+}
+
+bool BitReader::read_bool() {
+  return read(1);
+}
+
+std::int64_t BitReader::read_signed(unsigned int bits) {
+  std::uint64_t value = read(bits);
+  // Sign extend from the top written bit
+  if (bits < 64 && (value >> (bits - 1)) & 1)
+    value |= ~std::uint64_t{0} << bits;
+  return static_cast<std::int64_t>(value);
+}
+
+std::uint64_t BitReader::read_varint() {
+  std::uint64_t value = 0;
+  for (unsigned int shift = 0; shift < 64; shift += 7) {
+    value |= read(7) << shift;
+    if (!read_bool())
+      return value;
+  }
+  failed = true;
+  return 0;
+}
+
+std::uint64_t BitReader::read_at_most(unsigned int bits, std::uint64_t max) {
+  std::uint64_t value = read(bits);
+  if (value > max)
+    failed = true;
+  return value;
+}
+
+void BitReader::fail() {
+  failed = true;
+}
+
+bool BitReader::good() const {
+  return !failed;
+}
+
+namespace {
+std::uint32_t fnv1a(std::span<const std::uint8_t> bytes, std::uint32_t hash) {
+  for (std::uint8_t byte : bytes) {
+    hash ^= byte;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+constexpr std::uint32_t FNV_OFFSET_BASIS = 2166136261u;
+
+std::uint32_t checksum(std::uint8_t kind, std::span<const std::uint8_t> bytes) {
+  return fnv1a(bytes, fnv1a({&kind, 1}, FNV_OFFSET_BASIS));
+}
+
+void write_le(std::ostream& out, std::uint32_t value, int size) {
+  for (int byte = 0; byte < size; byte++)
+    out.put(static_cast<char>((value >> (8 * byte)) & 0xFF));
+}
+
+std::optional<std::uint32_t> read_le(std::istream& in, int size) {
+  std::uint32_t value = 0;
+  for (int byte = 0; byte < size; byte++) {
+    int c = in.get();
+    if (c == std::istream::traits_type::eof())
+      return std::nullopt;
+    value |= static_cast<std::uint32_t>(c) << (8 * byte);
+  }
+  return value;
+}
+}; // namespace
+
+namespace save_file {
+void write_header(std::ostream& out) {
+  out.write(MAGIC.data(), MAGIC.size());
+  write_le(out, VERSION, 2);
+}
+
+std::optional<std::uint16_t> read_header(std::istream& in) {
+  std::array<char, 4> magic;
+  if (!in.read(magic.data(), magic.size()) || magic != MAGIC)
+    return std::nullopt;
+  auto version = read_le(in, 2);
+  if (!version || *version > VERSION)
+    return std::nullopt;
+  return *version;
+}
+
+void write_record(std::ostream& out, RecordKind kind, const BitWriter& writer) {
+  auto payload = writer.data();
+  auto kind_byte = static_cast<std::uint8_t>(kind);
+  write_le(out, kind_byte, 1);
+  write_le(out, payload.size(), 4);
+  out.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+  write_le(out, checksum(kind_byte, payload), 4);
+}
+
+std::optional<Record> read_record(std::istream& in) {
+  Record record;
+  if (!read_record(in, record))
+    return std::nullopt;
+  return record;
+}
+
+bool read_record(std::istream& in, Record& record) {
+  auto kind = read_le(in, 1);
+  auto size = read_le(in, 4);
+  auto last_kind = static_cast<std::uint8_t>(RecordKind::ReplayEnd);
+  if (!kind || !size || *kind > last_kind)
+    return false;
+
+  // Payloads are a few hundred bytes at most, a bigger size means garbage
+  static constexpr std::uint32_t MAX_PAYLOAD_SIZE = 1 << 16;
+  if (*size > MAX_PAYLOAD_SIZE)
+    return false;
+
+  record.kind = static_cast<RecordKind>(*kind);
+  record.payload.resize(*size);
+  if (!in.read(reinterpret_cast<char*>(record.payload.data()), *size))
+    return false;
+  return read_le(in, 4) == checksum(*kind, record.payload);
+}
+} // namespace save_file
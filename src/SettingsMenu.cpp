@@ -1,29 +1,42 @@
 #include "SettingsMenu.hpp"
-#include "HandlingSettings.hpp"
 #include "raylib.h"
 #include <algorithm>
-#include <format>
 #include <fstream>
+#include <mutex>
 #include <utility>
 
-SettingsMenu::Config global_config = [] {
-  std::ifstream in("settings.raytris");
+static void save_config(const SettingsMenu::Config& config) {
+  std::ofstream out("settings.raytris", std::ios::binary);
+  write_config(out, config);
+}
+
+// Missing or unreadable settings start over from the defaults
+static SettingsMenu::Config load_config() {
+  std::ifstream in("settings.raytris", std::ios::binary);
   if (!in.good())
-    return SettingsMenu::Config{Resolution::Small, {20, 1, 30, 15, 7}};
+    return {};
+  return read_config(in).value_or(SettingsMenu::Config{});
+}
 
-  in.read(reinterpret_cast<char*>(&global_config), sizeof(global_config));
-  return global_config;
-}();
+// Games on other threads may read the config while the menu writes it
+static std::mutex config_mutex;
 
-const SettingsMenu::Config& SettingsMenu::config() {
-  return global_config;
+static SettingsMenu::Config& global_config() {
+  static SettingsMenu::Config config = load_config();
+  return config;
 }
 
+SettingsMenu::Config SettingsMenu::config() {
+  std::lock_guard lock(config_mutex);
+  return global_config();
+}
+
+SettingsMenu::SettingsMenu() : edited_config(config()) {}
+
 SettingsMenu::~SettingsMenu() {
-  std::ofstream out("settings.raytris");
-  out.write(
-    reinterpret_cast<const char*>(&global_config), sizeof(global_config)
-  );
+  std::lock_guard lock(config_mutex);
+  global_config() = edited_config;
+  save_config(edited_config);
 }
 
 std::pair<int, int> resolution_pair(Resolution resolution) {
@@ -43,10 +56,21 @@ std::pair<int, int> resolution_pair(Resolution resolution) {
   }
 }
 
+const char* to_string(RenderMode render_mode) {
+  switch (render_mode) {
+  case RenderMode::VSync:
+    return "VSync";
+  case RenderMode::Uncapped:
+    return "Uncapped";
+  case RenderMode::TickRate:
+    return "Tick Rate";
+  }
+  return "";
+}
+
 template <bool HIGHER>
-static void resize() {
+static void resize(Resolution& resolution) {
   constexpr auto RESOLUTIONS = std::to_underlying(Resolution::FullScreen) + 1;
-  auto&& resolution = global_config.resolution;
   auto inner = std::to_underlying(resolution);
   if constexpr (HIGHER)
     inner = (inner + 1) % RESOLUTIONS;
@@ -72,41 +96,40 @@ bool SettingsMenu::should_stop_running() const {
 }
 
 void SettingsMenu::draw() const {
-  const auto [width, height] = resolution_pair(global_config.resolution);
+  const auto [width, height] = resolution_pair(edited_config.resolution);
   const float fontSizeBig = height / 4.0;
-  const float fontSize = height / 12.0;
+  const float fontSize = height / 16.0;
 
   ClearBackground(LIGHTGRAY);
   DrawText(
-    "SETTINGS",
-    (width - MeasureText("SETTINGS", fontSizeBig)) / 2.0,
+    title.c_str(),
+    (width - title.width(fontSizeBig)) / 2.0,
     height / 2.0 - fontSize - fontSizeBig,
     fontSizeBig,
     RED
   );
 
-  using option = std::pair<std::string, std::string>;
-  option resolution = {"Resolution", std::format("{} x {}", width, height)};
-  option das = {
-    "Delayed Auto Shift", std::format("{}", global_config.handling_settings.das)
-  };
-  option softDropFrames = {
-    "Soft Drop Frames",
-    std::format("{}", global_config.handling_settings.soft_drop)
-  };
-
-  std::array options = {resolution, das, softDropFrames};
+  const auto& hand_set = edited_config.handling_settings;
+  const std::array<std::pair<const char*, const char*>, OPTIONS> options = {{
+    {"Resolution", resolution_text.c_str(width, height)},
+    {"Delayed Auto Shift", das_text.c_str(hand_set.das)},
+    {"Soft Drop Frames", soft_drop_text.c_str(hand_set.soft_drop)},
+    {"Auto Repeat Rate", arr_text.c_str(hand_set.arr)},
+    {"DAS Cut Delay", dcd_text.c_str(hand_set.dcd)},
+    {"Soft Drop Factor", sdf_text.c_str(hand_set.sdf)},
+    {"Frame Rate", to_string(edited_config.render_mode)},
+  }};
   for (std::size_t idx = 0; idx < options.size(); idx++) {
     const auto [option, value] = options[idx];
     DrawText(
-      option.c_str(),
+      option,
       width / 8.0f,
       height / 2.0f + idx * fontSize,
       fontSize,
       selected_option == idx ? BLUE : BLACK
     );
     DrawText(
-      value.c_str(),
+      value,
       width / 1.5f,
       height / 2.0f + idx * fontSize,
       fontSize,
@@ -115,8 +138,17 @@ void SettingsMenu::draw() const {
   }
 }
 
+// Left and Right step a handling setting between 0 and max
+static void adjust(int& value, int max) {
+  if (IsKeyPressed(KEY_LEFT))
+    value -= 1;
+  if (IsKeyPressed(KEY_RIGHT))
+    value += 1;
+  value = std::clamp(value, 0, max);
+}
+
 void SettingsMenu::update() {
-  auto&& hand_set = global_config.handling_settings;
+  auto&& hand_set = edited_config.handling_settings;
 
   if (IsKeyPressed(KEY_UP))
     selected_option = (selected_option + OPTIONS - 1) % OPTIONS;
@@ -125,20 +157,26 @@ void SettingsMenu::update() {
 
   if (selected_option == 0) {
     if (IsKeyPressed(KEY_RIGHT))
-      resize<true>();
+      resize<true>(edited_config.resolution);
     if (IsKeyPressed(KEY_LEFT))
-      resize<false>();
+      resize<false>(edited_config.resolution);
   } else if (selected_option == 1) {
-    if (IsKeyPressed(KEY_LEFT))
-      hand_set.das -= 1;
-    if (IsKeyPressed(KEY_RIGHT))
-      hand_set.das += 1;
-    hand_set.das = std::clamp(hand_set.das, 0, 20);
+    adjust(hand_set.das, 20);
   } else if (selected_option == 2) {
+    adjust(hand_set.soft_drop, 20);
+  } else if (selected_option == 3) {
+    adjust(hand_set.arr, 10);
+  } else if (selected_option == 4) {
+    adjust(hand_set.dcd, 20);
+  } else if (selected_option == 5) {
+    adjust(hand_set.sdf, 20);
+  } else if (selected_option == 6) {
+    constexpr auto MODES = std::to_underlying(RenderMode::TickRate) + 1;
+    auto mode = std::to_underlying(edited_config.render_mode);
     if (IsKeyPressed(KEY_LEFT))
-      hand_set.soft_drop -= 1;
+      mode = (mode + MODES - 1) % MODES;
     if (IsKeyPressed(KEY_RIGHT))
-      hand_set.soft_drop += 1;
-    hand_set.soft_drop = std::clamp(hand_set.soft_drop, 0, 20);
+      mode = (mode + 1) % MODES;
+    edited_config.render_mode = static_cast<RenderMode>(mode);
   }
 }
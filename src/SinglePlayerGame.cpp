@@ -2,7 +2,6 @@
 #include "DrawingDetails.hpp"
 #include "HandlingSettings.hpp"
 #include "Playfield.hpp"
-#include <fstream>
 
 static DrawingDetails makeDrawingDetails() {
   float blockLength = DrawingDetails::HEIGHT_SCALE_FACTOR * GetScreenHeight() /
@@ -14,47 +13,66 @@ static DrawingDetails makeDrawingDetails() {
   return {blockLength, position};
 };
 
-static constexpr Controller KEYBOARD_CONTROLS{
-  []() -> bool { return IsKeyPressed(KEY_R); },
-  []() -> bool { return IsKeyPressed(KEY_C); },
-  []() -> bool { return IsKeyPressed(KEY_LEFT); },
-  []() -> bool { return IsKeyPressed(KEY_RIGHT); },
-  []() -> bool { return IsKeyDown(KEY_LEFT); },
-  []() -> bool { return IsKeyDown(KEY_RIGHT); },
-  []() -> bool { return IsKeyPressed(KEY_UP); },
-  []() -> bool { return IsKeyPressed(KEY_Z); },
-  []() -> bool { return IsKeyPressed(KEY_A); },
-  []() -> bool { return IsKeyPressed(KEY_SPACE); },
-  []() -> bool { return IsKeyDown(KEY_DOWN); },
-  []() -> bool { return IsKeyDown(KEY_LEFT_CONTROL) && IsKeyPressed(KEY_Z); },
-  []() -> bool { return IsKeyPressed(KEY_ENTER); },
-  []() -> bool { return IsKeyPressed(KEY_ESCAPE); },
-};
+static constexpr KeyboardController::Bindings KEYBOARD_CONTROLS{{
+  {KEY_R},
+  {KEY_C},
+  {KEY_LEFT},
+  {KEY_RIGHT},
+  {KEY_LEFT},
+  {KEY_RIGHT},
+  {KEY_UP},
+  {KEY_Z},
+  {KEY_A},
+  {KEY_SPACE},
+  {KEY_DOWN},
+  {KEY_Z, KEY_LEFT_CONTROL},
+  {KEY_Y, KEY_LEFT_CONTROL},
+  {KEY_ENTER},
+  {KEY_ESCAPE},
+}};
 
 SinglePlayerGame::SinglePlayerGame(const HandlingSettings& settings) :
-  game(makeDrawingDetails(), KEYBOARD_CONTROLS, settings) {
-  if (std::ifstream in("save.raytris"); in.good())
-    in.read(reinterpret_cast<char*>(&game.playfield), sizeof(Playfield));
-  undoMoveStack.push(game.playfield);
+  game(makeDrawingDetails(), KEYBOARD_CONTROLS, settings),
+  history(game.playfield),
+  autosave("save.raytris") {
+  if (auto saved = Autosave::load("save.raytris")) {
+    game.playfield = *saved;
+    game.renderer.redraw_stack();
+  }
+  history.reset(game.playfield);
+  autosave.snapshot(game.playfield);
+  game.record("replay.raytris");
 }
 
-SinglePlayerGame::~SinglePlayerGame() {
-  std::ofstream out("save.raytris");
-  out.write(reinterpret_cast<const char*>(&game.playfield), sizeof(Playfield));
+// Undo and redo jump to a state the replay never reached, so the recording
+// starts over from there, and the stack is drawn anew
+void SinglePlayerGame::restored() {
+  game.renderer.redraw_stack();
+  autosave.snapshot(game.playfield);
+  game.recorder->begin(game.playfield);
 }
 
-void SinglePlayerGame::update() {
-  if (game.controller.undo()) {
-    if (!undoMoveStack.empty()) {
-      game.playfield = undoMoveStack.top();
-      undoMoveStack.pop();
-      if (undoMoveStack.empty())
-        undoMoveStack.push(game.playfield);
-      return;
-    }
+void SinglePlayerGame::update(std::span<const KeyEvent> events) {
+  game.poll(events);
+  if (game.inputs[Action::Undo]) {
+    if (history.undo(game.playfield))
+      restored();
+    return;
+  }
+  if (game.inputs[Action::Redo]) {
+    if (history.redo(game.playfield))
+      restored();
+    return;
+  }
+
+  bool locked = game.update();
+  if (game.inputs[Action::Restart]) {
+    history.reset(game.playfield);
+    autosave.snapshot(game.playfield);
+  } else if (locked) {
+    history.push(game.playfield);
+    autosave.lock(game.playfield);
   }
-  if (game.update())
-    undoMoveStack.push(game.playfield);
 }
 
 void SinglePlayerGame::draw() const {
@@ -62,5 +80,5 @@ void SinglePlayerGame::draw() const {
 }
 
 bool SinglePlayerGame::should_stop_running() const {
-  return game.controller.quit() && (game.paused || game.playfield.lost());
+  return game.inputs[Action::Quit] && (game.paused || game.playfield.lost());
 }
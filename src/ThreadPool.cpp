@@ -0,0 +1,94 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned thread_count) {
+  thread_count = std::max(thread_count, 1u);
+  slices = std::make_unique<Slice[]>(thread_count);
+  threads.reserve(thread_count);
+  for (unsigned worker = 0; worker < thread_count; worker++)
+    threads.emplace_back(&ThreadPool::work, this, worker);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(mutex);
+    stopping = true;
+  }
+  start.notify_all();
+  for (auto& thread : threads)
+    thread.join();
+}
+
+unsigned ThreadPool::size() const {
+  return threads.size();
+}
+
+bool ThreadPool::pop(unsigned worker, std::size_t& index) {
+  Slice& slice = slices[worker];
+  std::lock_guard lock(slice.mutex);
+  if (slice.begin == slice.end)
+    return false;
+  index = slice.begin++;
+  return true;
+}
+
+bool ThreadPool::steal(unsigned worker, std::size_t& index) {
+  for (unsigned offset = 1; offset < size(); offset++) {
+    Slice& victim = slices[(worker + offset) % size()];
+    std::size_t begin, end;
+    {
+      std::lock_guard lock(victim.mutex);
+      if (victim.begin == victim.end)
+        continue;
+      end = victim.end;
+      begin = victim.begin + (victim.end - victim.begin) / 2;
+      victim.end = begin;
+    }
+    // Our own slice is empty, so nobody else is touching it right now
+    Slice& slice = slices[worker];
+    std::lock_guard lock(slice.mutex);
+    slice.begin = begin + 1;
+    slice.end = end;
+    index = begin;
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::work(unsigned worker) {
+  std::uint64_t seen = 0;
+  for (;;) {
+    {
+      std::unique_lock lock(mutex);
+      start.wait(lock, [&] { return stopping || generation != seen; });
+      if (stopping)
+        return;
+      seen = generation;
+    }
+
+    std::size_t index;
+    while (pop(worker, index) || steal(worker, index))
+      (*task)(index, worker);
+
+    std::lock_guard lock(mutex);
+    if (--running == 0)
+      done.notify_all();
+  }
+}
+
+void ThreadPool::parallel_for(std::size_t count, const Task& _task) {
+  if (count == 0)
+    return;
+  std::unique_lock lock(mutex);
+  for (unsigned worker = 0; worker < size(); worker++) {
+    std::lock_guard slice_lock(slices[worker].mutex);
+    slices[worker].begin = count * worker / size();
+    slices[worker].end = count * (worker + 1) / size();
+  }
+  task = &_task;
+  running = size();
+  generation += 1;
+  start.notify_all();
+  done.wait(lock, [&] { return running == 0; });
+  task = nullptr;
+}
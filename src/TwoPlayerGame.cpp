@@ -1,5 +1,6 @@
 #include "TwoPlayerGame.hpp"
 #include "HandlingSettings.hpp"
+#include "Match.hpp"
 
 static DrawingDetails makeDrawingDetails1() {
   float blockLength{
@@ -25,49 +26,64 @@ static DrawingDetails makeDrawingDetails2() {
   return {blockLength, position};
 };
 
-static constexpr Controller CONTROLS_1{
-  []() -> bool { return false; },
-  []() -> bool { return IsKeyPressed(KEY_E); },
-  []() -> bool { return IsKeyPressed(KEY_A); },
-  []() -> bool { return IsKeyPressed(KEY_D); },
-  []() -> bool { return IsKeyDown(KEY_A); },
-  []() -> bool { return IsKeyDown(KEY_D); },
-  []() -> bool { return IsKeyPressed(KEY_W); },
-  []() -> bool { return IsKeyPressed(KEY_Q); },
-  []() -> bool { return IsKeyPressed(KEY_R); },
-  []() -> bool { return IsKeyPressed(KEY_Z); },
-  []() -> bool { return IsKeyDown(KEY_S); },
-  []() -> bool { return false; },
-  []() -> bool { return IsKeyPressed(KEY_ENTER); },
-  []() -> bool { return IsKeyPressed(KEY_ESCAPE); },
-};
+static constexpr KeyboardController::Bindings CONTROLS_1{{
+  {},
+  {KEY_E},
+  {KEY_A},
+  {KEY_D},
+  {KEY_A},
+  {KEY_D},
+  {KEY_W},
+  {KEY_Q},
+  {KEY_R},
+  {KEY_Z},
+  {KEY_S},
+  {},
+  {},
+  {KEY_ENTER},
+  {KEY_ESCAPE},
+}};
 
-static constexpr Controller CONTROLS_2{
-  []() -> bool { return false; },
-  []() -> bool { return IsKeyPressed(KEY_O); },
-  []() -> bool { return IsKeyPressed(KEY_J); },
-  []() -> bool { return IsKeyPressed(KEY_L); },
-  []() -> bool { return IsKeyDown(KEY_J); },
-  []() -> bool { return IsKeyDown(KEY_L); },
-  []() -> bool { return IsKeyPressed(KEY_I); },
-  []() -> bool { return IsKeyPressed(KEY_U); },
-  []() -> bool { return IsKeyPressed(KEY_P); },
-  []() -> bool { return IsKeyPressed(KEY_M); },
-  []() -> bool { return IsKeyDown(KEY_K); },
-  []() -> bool { return false; },
-  []() -> bool { return IsKeyPressed(KEY_ENTER); },
-  []() -> bool { return IsKeyPressed(KEY_ESCAPE); },
-};
+static constexpr KeyboardController::Bindings CONTROLS_2{{
+  {},
+  {KEY_O},
+  {KEY_J},
+  {KEY_L},
+  {KEY_J},
+  {KEY_L},
+  {KEY_I},
+  {KEY_U},
+  {KEY_P},
+  {KEY_M},
+  {KEY_K},
+  {},
+  {},
+  {KEY_ENTER},
+  {KEY_ESCAPE},
+}};
 
 TwoPlayerGame::TwoPlayerGame(
-  const HandlingSettings& settings1, const HandlingSettings& settings2
+  const HandlingSettings& settings1,
+  const HandlingSettings& settings2,
+  const std::optional<BotSettings>& cpu
 ) :
   game1(makeDrawingDetails1(), CONTROLS_1, settings1),
-  game2(makeDrawingDetails2(), CONTROLS_2, settings2) {}
+  game2(makeDrawingDetails2(), CONTROLS_2, settings2),
+  holes(random_seed()) {
+  if (cpu)
+    game2.play_bot(*cpu);
+}
 
-void TwoPlayerGame::update() {
-  game1.update();
-  game2.update();
+void TwoPlayerGame::update(std::span<const KeyEvent> events) {
+  game1.poll(events);
+  game2.poll(events);
+  // Lines are only sent by a lock, and a paused game keeps its last attack
+  bool locked1 = game1.update();
+  bool locked2 = game2.update();
+  if (locked1)
+    Match::send(game1.playfield, game2.playfield, holes);
+  if (locked2)
+    Match::send(game2.playfield, game1.playfield, holes);
   game2.paused = game1.paused;
 }
 
@@ -77,5 +93,5 @@ void TwoPlayerGame::draw() const {
 }
 
 bool TwoPlayerGame::should_stop_running() const {
-  return game1.controller.quit() && (game1.paused || game1.playfield.lost());
+  return game1.inputs[Action::Quit] && (game1.paused || game1.playfield.lost());
 }
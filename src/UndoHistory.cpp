@@ -0,0 +1,66 @@
+#include "UndoHistory.hpp"
+
+// A push holds one lock past MAX_LOCKS, and its keyframe, before dropping
+// the oldest KEYFRAME_INTERVAL
+UndoHistory::UndoHistory(const Playfield& playfield) :
+  keyframes(MAX_LOCKS / KEYFRAME_INTERVAL + 2),
+  locks(MAX_LOCKS + 1) {
+  reset(playfield);
+}
+
+void UndoHistory::reset(const Playfield& playfield) {
+  keyframes.clear();
+  keyframes.push_back(playfield);
+  locks.clear();
+  current = 0;
+}
+
+Playfield UndoHistory::state(std::size_t index) const {
+  std::size_t keyframe = index / KEYFRAME_INTERVAL;
+  Playfield playfield = keyframes[keyframe];
+  for (std::size_t i = keyframe * KEYFRAME_INTERVAL; i < index; i++)
+    playfield.replay(locks[i]);
+  return playfield;
+}
+
+void UndoHistory::push(const Playfield& playfield) {
+  // Locking the same piece as before after an undo is the same as a redo,
+  // and keeps the states after it
+  if (current < locks.size()) {
+    Playfield next = state(current + 1);
+    if (next == playfield && next.get_score() == playfield.get_score()) {
+      current += 1;
+      return;
+    }
+  }
+  // A new lock discards everything that could have been redone
+  locks.truncate(current);
+  keyframes.truncate(current / KEYFRAME_INTERVAL + 1);
+
+  locks.push_back(playfield.last_lock());
+  current += 1;
+  if (current % KEYFRAME_INTERVAL == 0)
+    keyframes.push_back(playfield);
+
+  if (locks.size() > MAX_LOCKS) {
+    locks.pop_front(KEYFRAME_INTERVAL);
+    keyframes.pop_front();
+    current -= KEYFRAME_INTERVAL;
+  }
+}
+
+bool UndoHistory::undo(Playfield& playfield) {
+  if (current == 0)
+    return false;
+  current -= 1;
+  playfield = state(current);
+  return true;
+}
+
+bool UndoHistory::redo(Playfield& playfield) {
+  if (current == locks.size())
+    return false;
+  current += 1;
+  playfield = state(current);
+  return true;
+}
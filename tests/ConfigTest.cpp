@@ -0,0 +1,108 @@
+#include "Config.hpp"
+#include "Serialization.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace {
+int failures = 0;
+
+void check(bool passed, const char* what) {
+  if (!passed && failures++ < 10)
+    std::printf("FAILED: %s\n", what);
+}
+
+bool same_handling(const HandlingSettings& a, const HandlingSettings& b) {
+  return a.gravity == b.gravity && a.soft_drop == b.soft_drop &&
+         a.lock_delay_frames == b.lock_delay_frames &&
+         a.lock_delay_resets == b.lock_delay_resets && a.das == b.das &&
+         a.arr == b.arr && a.dcd == b.dcd && a.sdf == b.sdf;
+}
+
+// Written the way versions 1 and 2 did: the resolution and the first five
+// handling settings, then a render mode only in later version 2 files
+std::string old_config(std::uint16_t version, const HandlingSettings& set,
+                       std::optional<RenderMode> render_mode = {}) {
+  std::ostringstream out;
+  out.write(save_file::MAGIC.data(), save_file::MAGIC.size());
+  out.put(char(version & 0xFF));
+  out.put(char(version >> 8));
+  BitWriter writer;
+  writer.write(std::to_underlying(Resolution::Big), 2);
+  for (int value :
+       {set.gravity, set.soft_drop, set.lock_delay_frames,
+        set.lock_delay_resets, set.das})
+    writer.write_signed(value, 32);
+  if (render_mode)
+    writer.write(std::to_underlying(*render_mode), 2);
+  save_file::write_record(out, save_file::RecordKind::Config, writer);
+  return out.str();
+}
+
+void check_old_layouts() {
+  HandlingSettings old_settings;
+  old_settings.gravity = 12;
+  old_settings.soft_drop = 2;
+  old_settings.lock_delay_frames = 40;
+  old_settings.lock_delay_resets = 10;
+  old_settings.das = 9;
+  for (std::uint16_t version = 1; version < save_file::TUNING_VERSION;
+       version++) {
+    std::istringstream in(old_config(version, old_settings));
+    auto config = read_config(in);
+    check(config.has_value(), "an old config loads");
+    if (!config)
+      continue;
+    check(config->resolution == Resolution::Big, "old resolution kept");
+    // Settings the old file predates come back as their defaults
+    check(same_handling(config->handling_settings, old_settings),
+          "old handling kept, newer settings defaulted");
+    check(config->render_mode == RenderMode::VSync, "render mode defaulted");
+  }
+
+  // A version 2 render mode cannot be told from padding, it is left unread
+  std::istringstream in(old_config(2, old_settings, RenderMode::TickRate));
+  auto config = read_config(in);
+  check(config.has_value(), "a version 2 config with a render mode loads");
+  if (config) {
+    check(same_handling(config->handling_settings, old_settings),
+          "handling kept next to a version 2 render mode");
+    check(config->render_mode == RenderMode::VSync,
+          "version 2 render mode left at the default");
+  }
+}
+
+void check_round_trip() {
+  Config config;
+  config.resolution = Resolution::Medium;
+  config.handling_settings.das = 4;
+  config.handling_settings.arr = 2;
+  config.handling_settings.dcd = 1;
+  config.handling_settings.sdf = 0;
+  config.render_mode = RenderMode::TickRate;
+  std::stringstream file;
+  write_config(file, config);
+  auto loaded = read_config(file);
+  check(loaded.has_value(), "a config loads back");
+  if (!loaded)
+    return;
+  check(loaded->resolution == config.resolution, "resolution round trips");
+  check(same_handling(loaded->handling_settings, config.handling_settings),
+        "handling round trips");
+  check(loaded->render_mode == config.render_mode, "render mode round trips");
+}
+}; // namespace
+
+int main() {
+  check_old_layouts();
+  check_round_trip();
+  if (failures > 0) {
+    std::printf("%d config checks failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("Config: old layouts load, the current one round trips\n");
+  return EXIT_SUCCESS;
+}
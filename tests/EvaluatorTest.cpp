@@ -0,0 +1,73 @@
+#include "BenchmarkStacks.hpp"
+#include "Evaluator.hpp"
+#include "MoveGenerator.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+int failures = 0;
+
+void check(const BoardFeatures& found, const BoardFeatures& expected,
+           const char* what) {
+  if (found != expected && failures++ < 10)
+    std::printf("FAILED: %s differs from the scalar features\n", what);
+}
+
+// Stacks of a random height with every cell below the top filled at a random
+// density, full rows and overhangs included
+std::array<Grid::RowMask, Grid::HEIGHT> random_board(Pcg32& generator) {
+  std::array<Grid::RowMask, Grid::HEIGHT> rows{};
+  const auto height = generator.bounded(Grid::HEIGHT + 1);
+  const auto density = generator.bounded(101);
+  for (std::size_t y = Grid::HEIGHT - height; y < Grid::HEIGHT; y++)
+    for (std::size_t x = 0; x < Grid::WIDTH; x++)
+      if (generator.bounded(100) < density)
+        rows[y] |= 1u << x;
+  return rows;
+}
+
+// Every placement of every tetromino on the stack, found without and with
+// copying the grid
+void check_placements(const Grid& grid) {
+  MoveGenerator generator;
+  for (int t = 0; t < std::to_underlying(Tetromino::Empty); t++) {
+    FallingPiece piece(
+      static_cast<Tetromino>(t),
+      Playfield::INITIAL_X_POSITION,
+      Playfield::INITIAL_Y_POSITION
+    );
+    for (const auto& placement : generator.generate(grid, piece)) {
+      Grid board = grid;
+      board.place(placement.piece);
+      BoardFeatures expected = scalar_board_features(board.row_masks());
+      expected.cleared_rows = board.clear_full_rows(placement.piece);
+      if (expected.cleared_rows > 0) {
+        const int cleared = expected.cleared_rows;
+        expected = scalar_board_features(board.row_masks());
+        expected.cleared_rows = cleared;
+      }
+      check(board_features(grid, placement.piece), expected, "placement");
+    }
+  }
+}
+}; // namespace
+
+int main() {
+  static constexpr int BOARDS = 200000;
+  Pcg32 generator(0x5EED);
+  for (int i = 0; i < BOARDS; i++) {
+    const auto rows = random_board(generator);
+    check(board_features(rows), scalar_board_features(rows), "random board");
+  }
+  check_placements(Grid());
+  check_placements(make_grid(HOLES_STACK));
+  check_placements(make_grid(RAGGED_STACK));
+
+  if (failures > 0) {
+    std::printf("%d boards differ with %s\n", failures, BOARD_FEATURES_ISA);
+    return EXIT_FAILURE;
+  }
+  std::printf("Evaluator: %d random boards and 3 stacks match with %s\n",
+              BOARDS, BOARD_FEATURES_ISA);
+  return EXIT_SUCCESS;
+}
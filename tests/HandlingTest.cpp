@@ -0,0 +1,69 @@
+#include "Playfield.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+
+namespace {
+int failures = 0;
+
+void check(int found, int expected, const char* what) {
+  if (found != expected && failures++ < 10)
+    std::printf("FAILED: %s, column %d instead of %d\n", what, found, expected);
+}
+
+Inputs press(std::initializer_list<Action> actions) {
+  Inputs inputs;
+  for (Action action : actions)
+    inputs.set(action);
+  return inputs;
+}
+
+// Runs the ticks on a fresh game, then hard drops and returns the column the
+// piece locked in. Playfield keeps the falling piece to itself, the lock
+// journal does not.
+int locked_x(const HandlingSettings& settings,
+             std::initializer_list<Inputs> ticks) {
+  Playfield playfield(0x5EED);
+  for (Inputs inputs : ticks)
+    playfield.update(inputs, settings);
+  playfield.update(press({Action::HardDrop}), settings);
+  return playfield.last_lock().locked_piece.x;
+}
+
+// With DAS 0 and ARR 1 a held key shifts every tick, so each tick the cut
+// holds off shows up as a column missing
+void check_das_cut() {
+  HandlingSettings settings;
+  settings.das = 0;
+  settings.arr = 1;
+  settings.dcd = 1;
+  const Inputs rotate = press({Action::RightDas, Action::Clockwise});
+  const Inputs hold = press({Action::RightDas});
+  const Inputs drop = press({Action::HardDrop});
+
+  // The rotation comes after the tick's shift, the tick after it is held off
+  const int rotated = locked_x(settings, {press({Action::Clockwise})});
+  check(locked_x(settings, {rotate, hold}), rotated + 1, "rotation, cut");
+  check(locked_x(settings, {rotate, hold, hold}), rotated + 2,
+        "rotation, cut over");
+
+  // Same for the first tick of the piece spawned by a lock
+  const int spawned = locked_x(settings, {drop});
+  check(locked_x(settings, {drop, hold}), spawned, "lock, cut");
+  check(locked_x(settings, {drop, hold, hold}), spawned + 1, "lock, cut over");
+
+  settings.dcd = 0;
+  check(locked_x(settings, {rotate, hold}), rotated + 2, "rotation, no cut");
+  check(locked_x(settings, {drop, hold}), spawned + 1, "lock, no cut");
+}
+}; // namespace
+
+int main() {
+  check_das_cut();
+  if (failures > 0) {
+    std::printf("%d handling checks failed\n", failures);
+    return EXIT_FAILURE;
+  }
+  std::printf("Handling: DAS cut delay holds off auto shift as set\n");
+  return EXIT_SUCCESS;
+}
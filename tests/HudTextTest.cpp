@@ -0,0 +1,75 @@
+#include "HudText.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Counts every allocation, a steady HUD frame must not make any
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size) {
+  allocations++;
+  if (void* memory = std::malloc(size == 0 ? 1 : size))
+    return memory;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+// Stands in for raylib, the test only needs how often text is measured
+static int measured = 0;
+
+int measure_text(const char* text, int font_size) {
+  measured++;
+  return std::strlen(text) * font_size / 2;
+}
+
+static int failures = 0;
+
+static void check(bool passed, const char* what) {
+  if (!passed) {
+    std::printf("FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+// What the renderer draws every frame: the score, combo and b2b counters and
+// a constant label, each measured to be centred
+int main() {
+  HudText<unsigned long> score{"{:09}"};
+  HudText<unsigned int> combo{"{}"};
+  HudText<int, int> resolution{"{} x {}"};
+  HudLabel paused("Game Paused");
+
+  check(std::strcmp(score.c_str(1234), "000001234") == 0, "score format");
+  check(std::strcmp(resolution.c_str(800, 600), "800 x 600") == 0, "format");
+
+  measured = 0;
+  const std::size_t before = allocations;
+  int width = 0;
+  for (unsigned int frame = 0; frame < 10000; frame++) {
+    // The score changes every 60 frames and the combo every 600, the rest
+    // stays the same
+    width += score.width(20) + paused.width(40);
+    score.c_str(frame / 60 * 100);
+    combo.c_str(frame / 600);
+    resolution.c_str(800, 600);
+    width += combo.width(20) + resolution.width(20);
+  }
+  check(allocations == before, "steady frames do not allocate");
+  // Text is only measured again once it changed
+  check(measured < 10000 / 60 * 3, "widths are cached");
+  check(width > 0, "widths are measured");
+
+  if (failures > 0)
+    return EXIT_FAILURE;
+  std::printf("HudText: 10000 frames, %d measurements, no allocations\n",
+              measured);
+  return EXIT_SUCCESS;
+}